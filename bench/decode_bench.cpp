@@ -0,0 +1,264 @@
+// 点记录解码基准测试：无需图形上下文，结果以JSON格式输出
+//
+// 对每种点记录布局分别测量特化解码和通用解码的吞吐量（输入和输出的GB/s）
+// 测量前先检查两者的输出逐字节一致，不一致时报错退出
+// 用法：mviz_decode_bench [--out 文件] [--points 数量] [--min-time 秒]
+
+#include "visualization/PointRecordDecoder.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace mviz {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 单项测试结果
+struct BenchResult {
+    std::string layout;
+    std::string decoder;
+    size_t pointStep;
+    size_t points;
+    size_t iterations;
+    double nsPerPoint;
+    double inputGBps;
+    double outputGBps;
+};
+
+// 测试配置
+struct BenchConfig {
+    size_t points = 1000000;  // 每帧点数
+    double minTime = 0.3;     // 每项测试至少运行的时长（秒）
+};
+
+// 测试的点记录布局
+struct BenchLayout {
+    std::string name;
+    std::vector<PointField> fields;
+    size_t pointStep;
+};
+
+PointField field(const char* name, uint32_t offset, PointFieldType type) {
+    PointField result;
+    result.name = name;
+    result.offset = offset;
+    result.type = type;
+    return result;
+}
+
+std::vector<BenchLayout> makeLayouts() {
+    const PointField x = field("x", 0, PointFieldType::FLOAT32);
+    const PointField y = field("y", 4, PointFieldType::FLOAT32);
+    const PointField z = field("z", 8, PointFieldType::FLOAT32);
+    
+    std::vector<BenchLayout> layouts;
+    layouts.push_back(BenchLayout{"xyz", {x, y, z}, 12});
+    layouts.push_back(BenchLayout{"xyz_padded", {x, y, z}, 16});
+    layouts.push_back(BenchLayout{"xyzi", {x, y, z, field("intensity", 12, PointFieldType::FLOAT32)}, 16});
+    layouts.push_back(BenchLayout{"xyzi_padded", {x, y, z, field("intensity", 16, PointFieldType::FLOAT32)}, 32});
+    layouts.push_back(BenchLayout{"xyzrgb", {x, y, z, field("rgb", 12, PointFieldType::FLOAT32)}, 16});
+    layouts.push_back(BenchLayout{"xyzrgb_padded", {x, y, z, field("rgb", 16, PointFieldType::FLOAT32)}, 32});
+    layouts.push_back(BenchLayout{"xyzirgb", {x, y, z, field("intensity", 12, PointFieldType::FLOAT32),
+        field("rgb", 16, PointFieldType::FLOAT32)}, 20});
+    layouts.push_back(BenchLayout{"xyzirgb_padded", {x, y, z, field("intensity", 16, PointFieldType::FLOAT32),
+        field("rgb", 20, PointFieldType::FLOAT32)}, 32});
+    
+    // 多线激光雷达驱动常见的布局，没有特化版本
+    layouts.push_back(BenchLayout{"lidar", {x, y, z,
+        field("intensity", 16, PointFieldType::FLOAT32),
+        field("t", 20, PointFieldType::UINT32),
+        field("reflectivity", 24, PointFieldType::UINT16),
+        field("ring", 26, PointFieldType::UINT16)}, 48});
+    return layouts;
+}
+
+// 按字段描述生成随机点记录，填充字节为0
+std::vector<uint8_t> makeRecords(const BenchLayout& layout, size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<uint32_t> bits;
+    
+    std::vector<uint8_t> records(count * layout.pointStep, 0);
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* record = records.data() + i * layout.pointStep;
+        for (const PointField& field : layout.fields) {
+            uint8_t* out = record + field.offset;
+            if (field.name == "x" || field.name == "y" || field.name == "z") {
+                const float value = position(rng);
+                std::memcpy(out, &value, sizeof(value));
+            } else if (field.name == "rgb") {
+                // 按PCL的约定，打包的颜色以float字段存储，这里直接写入位模式
+                const uint32_t value = bits(rng) | 0xFF000000u;
+                std::memcpy(out, &value, sizeof(value));
+            } else if (field.type == PointFieldType::FLOAT32) {
+                const float value = unit(rng);
+                std::memcpy(out, &value, sizeof(value));
+            } else if (field.type == PointFieldType::UINT32) {
+                const uint32_t value = bits(rng);
+                std::memcpy(out, &value, sizeof(value));
+            } else if (field.type == PointFieldType::UINT16) {
+                const uint16_t value = static_cast<uint16_t>(bits(rng) & 0x7F);
+                std::memcpy(out, &value, sizeof(value));
+            }
+        }
+    }
+    return records;
+}
+
+// 解码输出：位置和颜色与映射的顶点缓冲区中的位置块和颜色块排列相同，强度与CPU端的属性通道相同
+struct DecodeOutput {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> colors;
+    std::vector<float> intensity;
+    PointDecodeTarget target;
+    
+    explicit DecodeOutput(size_t count)
+        : positions(count)
+        , colors(count)
+        , intensity(count)
+    {
+        target.positions = positions.data();
+        target.colors = colors.data();
+        target.intensity = intensity.data();
+    }
+    
+    DecodeOutput(const DecodeOutput&) = delete;
+    DecodeOutput& operator=(const DecodeOutput&) = delete;
+};
+
+// 逐字节比较两次解码的输出（包括包围盒）
+bool sameOutput(const DecodeOutput& a, const DecodeOutput& b) {
+    const size_t count = a.positions.size();
+    return std::memcmp(a.positions.data(), b.positions.data(), count * sizeof(glm::vec3)) == 0 &&
+           std::memcmp(a.colors.data(), b.colors.data(), count * sizeof(uint32_t)) == 0 &&
+           std::memcmp(a.intensity.data(), b.intensity.data(), count * sizeof(float)) == 0 &&
+           std::memcmp(&a.target.min, &b.target.min, sizeof(glm::vec3)) == 0 &&
+           std::memcmp(&a.target.max, &b.target.max, sizeof(glm::vec3)) == 0;
+}
+
+// 检查特化版本与通用版本的输出是否一致；没有特化版本的布局直接通过
+bool verifyDecoders(const BenchLayout& layout, const std::vector<uint8_t>& records, size_t count) {
+    const PointRecordDecoder specialized(layout.fields, layout.pointStep, true);
+    const PointRecordDecoder generic(layout.fields, layout.pointStep, false);
+    if (!specialized.isSpecialized()) {
+        return true;
+    }
+    
+    DecodeOutput expected(count);
+    DecodeOutput actual(count);
+    generic.decode(records.data(), count, expected.target);
+    specialized.decode(records.data(), count, actual.target);
+    return sameOutput(expected, actual);
+}
+
+// 重复解码直到达到最短时长
+BenchResult runDecode(const BenchLayout& layout, const std::vector<uint8_t>& records, size_t count, bool specialize,
+                      double minTime) {
+    const PointRecordDecoder decoder(layout.fields, layout.pointStep, specialize);
+    DecodeOutput output(count);
+    
+    // 预热一次，使输出页面已经分配
+    decoder.decode(records.data(), count, output.target);
+    
+    size_t iterations = 0;
+    const auto start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        decoder.decode(records.data(), count, output.target);
+        ++iterations;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minTime);
+    
+    const double points = static_cast<double>(count) * static_cast<double>(iterations);
+    const double outputBytes = sizeof(glm::vec3) + sizeof(uint32_t) + sizeof(float);
+    
+    BenchResult result;
+    result.layout = layout.name;
+    result.decoder = decoder.getLayoutName();
+    result.pointStep = layout.pointStep;
+    result.points = count;
+    result.iterations = iterations;
+    result.nsPerPoint = elapsed * 1e9 / points;
+    result.inputGBps = points * static_cast<double>(layout.pointStep) / elapsed / 1e9;
+    result.outputGBps = points * outputBytes / elapsed / 1e9;
+    return result;
+}
+
+std::string toJson(const std::vector<BenchResult>& results) {
+    std::ostringstream out;
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        out << "    {\"layout\": \"" << result.layout << "\", "
+            << "\"decoder\": \"" << result.decoder << "\", "
+            << "\"point_step\": " << result.pointStep << ", "
+            << "\"points\": " << result.points << ", "
+            << "\"iterations\": " << result.iterations << ", "
+            << "\"ns_per_point\": " << result.nsPerPoint << ", "
+            << "\"input_gb_per_sec\": " << result.inputGBps << ", "
+            << "\"output_gb_per_sec\": " << result.outputGBps << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+} // namespace
+} // namespace mviz
+
+int main(int argc, char* argv[]) {
+    using namespace mviz;
+    
+    BenchConfig config;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            config.points = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            config.minTime = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--out file] [--points count] [--min-time seconds]" << std::endl;
+            return 1;
+        }
+    }
+    if (config.points == 0) {
+        std::cerr << "--points must be positive" << std::endl;
+        return 1;
+    }
+    
+    std::vector<BenchResult> results;
+    std::mt19937 rng(7);
+    for (const BenchLayout& layout : makeLayouts()) {
+        std::cerr << "Decoding " << layout.name << " (" << layout.pointStep << " bytes per point)..." << std::endl;
+        const std::vector<uint8_t> records = makeRecords(layout, config.points, rng);
+        if (!verifyDecoders(layout, records, config.points)) {
+            std::cerr << "Specialized and generic decoders disagree on layout " << layout.name << std::endl;
+            return 1;
+        }
+        
+        // 特化版本与通用版本对比；没有特化版本的布局两次都是通用版本，只记录一次
+        const BenchResult specialized = runDecode(layout, records, config.points, true, config.minTime);
+        results.push_back(specialized);
+        if (specialized.decoder != "generic") {
+            results.push_back(runDecode(layout, records, config.points, false, config.minTime));
+        }
+    }
+    
+    const std::string json = toJson(results);
+    if (outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream output(outputPath);
+        output << json;
+    }
+    return 0;
+}
\ No newline at end of file
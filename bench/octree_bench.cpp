@@ -0,0 +1,351 @@
+// 八叉树LOD基准测试：生成合成地形点云并转换为八叉树文件，沿固定路线飞行，
+// 每帧用Camera驱动LOD选择并从映射的文件中加载节点（模拟显存缓存），结果以JSON格式输出。
+// 无需图形上下文：帧时间为CPU端的选择和加载时间，不含GPU绘制。
+//
+// 用法：mviz_octree_bench [--points 数量] [--frames 帧数] [--budget 点数] [--gpu-mb 兆字节]
+//                         [--file 八叉树文件] [--keep] [--per-frame] [--out 文件]
+
+#include "core/Camera.h"
+#include "data/OctreeBuilder.h"
+#include "data/OctreeFile.h"
+#include "visualization/OctreeLOD.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace mviz {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 防止读取节点数据的循环被编译器优化掉
+volatile uint32_t g_sink = 0;
+
+// 测试配置
+struct BenchConfig {
+    uint64_t points = 20000000;    // 合成点云的点数
+    size_t frames = 600;           // 飞行的帧数
+    size_t pointBudget = 5000000;  // LOD点数预算
+    size_t gpuMegabytes = 512;     // 模拟的显存上限
+    size_t loadsPerFrame = 8;      // 每帧最多加载的节点数
+    std::string file;              // 八叉树文件，为空时使用临时文件
+    bool keep = false;             // 保留生成的八叉树文件
+    bool perFrame = false;         // 输出每帧的结果
+};
+
+// 地形的边长（米）
+constexpr float TERRAIN_SIZE = 2000.0f;
+
+// 地形高度（y轴向上，与相机的默认上方向一致）
+float terrainHeight(float x, float z) {
+    return 20.0f * std::sin(x * 0.01f) * std::cos(z * 0.013f) + 5.0f * std::sin(x * 0.07f + z * 0.05f);
+}
+
+// 合成地形点云：在地形表面上均匀随机采样，按高度着色
+class TerrainPointSource : public OctreePointSource {
+public:
+    explicit TerrainPointSource(uint64_t count)
+        : m_count(count)
+        , m_generated(0)
+    {
+    }
+    
+    bool hasColors() const override { return true; }
+    
+    bool rewind() override {
+        m_rng.seed(42);
+        m_generated = 0;
+        return true;
+    }
+    
+    size_t read(std::vector<glm::vec3>& points, std::vector<glm::vec3>& colors, size_t maxCount) override {
+        std::uniform_real_distribution<float> position(0.0f, TERRAIN_SIZE);
+        std::normal_distribution<float> noise(0.0f, 0.05f);
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(maxCount, m_count - m_generated));
+        for (size_t i = 0; i < count; ++i) {
+            const float x = position(m_rng);
+            const float z = position(m_rng);
+            const float y = terrainHeight(x, z) + noise(m_rng);
+            points.emplace_back(x, y, z);
+            
+            const float t = (y + 25.0f) / 50.0f;
+            colors.emplace_back(t, 0.5f + 0.5f * (1.0f - t), 1.0f - t);
+        }
+        m_generated += count;
+        return count;
+    }
+    
+private:
+    uint64_t m_count;
+    uint64_t m_generated;
+    std::mt19937 m_rng;
+};
+
+// 单帧结果
+struct FrameResult {
+    double frameMs;
+    double selectMs;
+    double loadMs;
+    size_t drawnPoints;
+    size_t drawnNodes;
+    size_t loadedNodes;
+    size_t cachedBytes;
+};
+
+// 模拟的节点缓存：策略与OctreePointCloudVisual相同（LRU淘汰、每帧加载数上限），加载即读取映射的节点数据
+class NodeCacheSimulator {
+public:
+    NodeCacheSimulator(const OctreeFile& file, size_t limitBytes)
+        : m_file(file)
+        , m_limitBytes(limitBytes)
+        , m_cachedBytes(0)
+        , m_frame(0)
+        , m_loaded(file.getNodeCount(), false)
+        , m_lastUsed(file.getNodeCount(), 0)
+    {
+    }
+    
+    bool isLoaded(uint32_t node) const { return m_loaded[node]; }
+    size_t getCachedBytes() const { return m_cachedBytes; }
+    
+    void beginFrame(const OctreeSelection& selection) {
+        ++m_frame;
+        for (uint32_t node : selection.visible) {
+            m_lastUsed[node] = m_frame;
+        }
+    }
+    
+    // 按优先级加载，返回加载的节点数
+    size_t load(const std::vector<uint32_t>& missing, size_t maxLoads) {
+        size_t loads = 0;
+        for (uint32_t node : missing) {
+            if (loads >= maxLoads) break;
+            
+            const size_t bytes = m_file.getNodeDataSize(node);
+            if (bytes > m_limitBytes || !evictUntil(m_limitBytes - bytes)) break;
+            
+            // 读取所有页面，相当于上传时驱动从映射的内存中复制数据
+            const uint8_t* data = m_file.getNodeData(node);
+            uint32_t checksum = 0;
+            for (size_t i = 0; i < bytes; i += 64) {
+                checksum += data[i];
+            }
+            g_sink = g_sink + checksum;
+            
+            m_loaded[node] = true;
+            m_lastUsed[node] = m_frame;
+            m_cachedBytes += bytes;
+            ++loads;
+        }
+        return loads;
+    }
+    
+private:
+    bool evictUntil(size_t targetBytes) {
+        if (m_cachedBytes <= targetBytes) {
+            return true;
+        }
+        
+        std::vector<uint32_t> candidates;
+        for (uint32_t node = 0; node < m_loaded.size(); ++node) {
+            if (m_loaded[node] && m_lastUsed[node] < m_frame) {
+                candidates.push_back(node);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+            return m_lastUsed[a] < m_lastUsed[b];
+        });
+        for (uint32_t node : candidates) {
+            if (m_cachedBytes <= targetBytes) break;
+            m_loaded[node] = false;
+            m_cachedBytes -= m_file.getNodeDataSize(node);
+        }
+        return m_cachedBytes <= targetBytes;
+    }
+    
+    const OctreeFile& m_file;
+    size_t m_limitBytes;
+    size_t m_cachedBytes;
+    uint64_t m_frame;
+    std::vector<bool> m_loaded;
+    std::vector<uint64_t> m_lastUsed;
+};
+
+// 飞行路线上第frame帧的相机：先从高空俯瞰整个地形，再降低高度贴地飞过，最后拉高
+void placeCamera(Camera& camera, size_t frame, size_t frames) {
+    // 沿-z方向飞行，与相机默认的朝向一致
+    const float t = frames > 1 ? static_cast<float>(frame) / (frames - 1) : 0.0f;
+    const float z = TERRAIN_SIZE - 100.0f - t * (TERRAIN_SIZE - 200.0f);
+    const float x = TERRAIN_SIZE * 0.5f + 300.0f * std::sin(t * 6.2831853f);
+    const float altitude = 30.0f + 1500.0f * std::pow(std::abs(2.0f * t - 1.0f), 3.0f);
+    
+    camera.setPosition(glm::vec3(x, terrainHeight(x, z) + altitude, z));
+    camera.setTarget(glm::vec3(x, terrainHeight(x, z - 200.0f), z - 200.0f));
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(fraction * (values.size() - 1))];
+}
+
+std::string toJson(const BenchConfig& config, const OctreeFile& file, double buildSeconds,
+                   const std::vector<FrameResult>& results) {
+    std::vector<double> frameMs;
+    double drawnSum = 0.0;
+    size_t drawnMax = 0;
+    size_t loadedSum = 0;
+    for (const FrameResult& result : results) {
+        frameMs.push_back(result.frameMs);
+        drawnSum += result.drawnPoints;
+        drawnMax = std::max(drawnMax, result.drawnPoints);
+        loadedSum += result.loadedNodes;
+    }
+    double frameSum = 0.0;
+    for (double ms : frameMs) {
+        frameSum += ms;
+    }
+    const double frameCount = results.empty() ? 1.0 : static_cast<double>(results.size());
+    
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"points\": " << file.getHeader().pointCount << ",\n"
+        << "  \"nodes\": " << file.getNodeCount() << ",\n"
+        << "  \"build_seconds\": " << buildSeconds << ",\n"
+        << "  \"point_budget\": " << config.pointBudget << ",\n"
+        << "  \"gpu_limit_mb\": " << config.gpuMegabytes << ",\n"
+        << "  \"frames\": " << results.size() << ",\n"
+        << "  \"frame_ms_avg\": " << frameSum / frameCount << ",\n"
+        << "  \"frame_ms_p50\": " << percentile(frameMs, 0.5) << ",\n"
+        << "  \"frame_ms_p95\": " << percentile(frameMs, 0.95) << ",\n"
+        << "  \"frame_ms_max\": " << percentile(frameMs, 1.0) << ",\n"
+        << "  \"drawn_points_avg\": " << drawnSum / frameCount << ",\n"
+        << "  \"drawn_points_max\": " << drawnMax << ",\n"
+        << "  \"nodes_loaded\": " << loadedSum;
+    
+    if (config.perFrame) {
+        out << ",\n  \"per_frame\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const FrameResult& result = results[i];
+            out << "    {\"frame_ms\": " << result.frameMs << ", "
+                << "\"select_ms\": " << result.selectMs << ", "
+                << "\"load_ms\": " << result.loadMs << ", "
+                << "\"drawn_points\": " << result.drawnPoints << ", "
+                << "\"drawn_nodes\": " << result.drawnNodes << ", "
+                << "\"loaded_nodes\": " << result.loadedNodes << ", "
+                << "\"cached_bytes\": " << result.cachedBytes << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]";
+    }
+    out << "\n}\n";
+    return out.str();
+}
+
+} // namespace
+} // namespace mviz
+
+int main(int argc, char* argv[]) {
+    using namespace mviz;
+    
+    BenchConfig config;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            config.points = static_cast<uint64_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            config.frames = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            config.pointBudget = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--gpu-mb") == 0 && i + 1 < argc) {
+            config.gpuMegabytes = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            config.file = argv[++i];
+        } else if (std::strcmp(argv[i], "--keep") == 0) {
+            config.keep = true;
+        } else if (std::strcmp(argv[i], "--per-frame") == 0) {
+            config.perFrame = true;
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--points count] [--frames count] [--budget points] [--gpu-mb megabytes]"
+                      << " [--file octree] [--keep] [--per-frame] [--out file]" << std::endl;
+            return 1;
+        }
+    }
+    
+    // 指定的文件已存在时直接使用，否则生成
+    const std::string path = config.file.empty() ? "mviz_octree_bench.octree" : config.file;
+    double buildSeconds = 0.0;
+    OctreeFile file;
+    if (config.file.empty() || !std::ifstream(path).good()) {
+        std::cerr << "Building octree with " << config.points << " points..." << std::endl;
+        TerrainPointSource source(config.points);
+        const auto start = Clock::now();
+        if (!buildOctree(source, path, OctreeBuildOptions())) {
+            return 1;
+        }
+        buildSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    if (!file.open(path)) {
+        return 1;
+    }
+    
+    Camera camera;
+    camera.setPerspective(45.0f, 16.0f / 9.0f, 0.1f, 10000.0f);
+    const int viewportHeight = 1080;
+    
+    OctreeLODOptions options;
+    options.pointBudget = config.pointBudget;
+    NodeCacheSimulator cache(file, config.gpuMegabytes << 20);
+    OctreeSelection selection;
+    std::vector<FrameResult> results;
+    
+    std::cerr << "Flying through " << config.frames << " frames..." << std::endl;
+    for (size_t frame = 0; frame < config.frames; ++frame) {
+        placeCamera(camera, frame, config.frames);
+        
+        const auto start = Clock::now();
+        const OctreeView view = OctreeView::fromCamera(camera, glm::mat4(1.0f), viewportHeight);
+        selectOctreeNodes(file, view, options, [&cache](uint32_t node) { return cache.isLoaded(node); }, selection);
+        cache.beginFrame(selection);
+        const auto selected = Clock::now();
+        const size_t loaded = cache.load(selection.missing, config.loadsPerFrame);
+        const auto end = Clock::now();
+        
+        results.push_back(FrameResult{
+            std::chrono::duration<double, std::milli>(end - start).count(),
+            std::chrono::duration<double, std::milli>(selected - start).count(),
+            std::chrono::duration<double, std::milli>(end - selected).count(),
+            selection.visiblePoints,
+            selection.visible.size(),
+            loaded,
+            cache.getCachedBytes()
+        });
+    }
+    
+    const std::string json = toJson(config, file, buildSeconds, results);
+    if (outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream output(outputPath);
+        output << json;
+    }
+    
+    file.close();
+    if (config.file.empty() && !config.keep) {
+        std::remove(path.c_str());
+    }
+    return 0;
+}
\ No newline at end of file
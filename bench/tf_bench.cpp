@@ -0,0 +1,317 @@
+// TF性能基准测试：无需图形上下文，结果以JSON格式输出
+//
+// 用法：mviz_tf_bench [--out 文件] [--min-time 秒] [--max-frames 数量]
+
+#include "core/TFManager.h"
+#include "core/FlatTFTree.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mviz {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 单项测试结果
+struct BenchResult {
+    std::string name;
+    std::string topology;
+    size_t frames;
+    size_t iterations;
+    double nsPerOp;
+};
+
+// 测试配置
+struct BenchConfig {
+    double minTime = 0.2;        // 每项测试至少运行的时长（秒）
+    size_t maxFrames = 50000;    // 最大树规模
+};
+
+// 防止被测代码被编译器优化掉
+volatile float g_sink = 0.0f;
+
+void consume(const Transform& transform) {
+    g_sink = g_sink + transform.translation.x;
+}
+
+void consume(const glm::vec3& value) {
+    g_sink = g_sink + value.x;
+}
+
+// 生成的树拓扑：parents[i]为第i个坐标系的父坐标系下标，0为世界坐标系
+struct Topology {
+    std::string name;
+    std::vector<size_t> parents;
+};
+
+Topology makeChain(size_t frames) {
+    Topology topology{"chain", std::vector<size_t>(frames, 0)};
+    for (size_t i = 1; i < frames; ++i) {
+        topology.parents[i] = i - 1;
+    }
+    return topology;
+}
+
+Topology makeStar(size_t frames) {
+    return Topology{"star", std::vector<size_t>(frames, 0)};
+}
+
+Topology makeRandomTree(size_t frames, std::mt19937& rng) {
+    Topology topology{"random", std::vector<size_t>(frames, 0)};
+    for (size_t i = 1; i < frames; ++i) {
+        topology.parents[i] = std::uniform_int_distribution<size_t>(0, i - 1)(rng);
+    }
+    return topology;
+}
+
+Transform randomTransform(std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    glm::quat rotation = glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng)));
+    return Transform(glm::vec3(dist(rng), dist(rng), dist(rng)), rotation);
+}
+
+// 重复执行op直到达到最短运行时长，op每次调用执行batch次操作
+template <typename Op>
+BenchResult measure(const std::string& name, const Topology& topology, const BenchConfig& config,
+                    size_t batch, Op&& op) {
+    size_t iterations = 0;
+    const auto start = Clock::now();
+    auto now = start;
+    do {
+        op();
+        iterations += batch;
+        now = Clock::now();
+    } while (std::chrono::duration<double>(now - start).count() < config.minTime);
+    
+    double ns = std::chrono::duration<double, std::nano>(now - start).count();
+    return BenchResult{name, topology.name, topology.parents.size(), iterations, ns / iterations};
+}
+
+// 按拓扑创建坐标系句柄并填充TF树
+std::vector<FrameId> populate(TFManager& tf, const Topology& topology, std::mt19937& rng) {
+    std::vector<FrameId> ids(topology.parents.size());
+    ids[0] = tf.getWorldFrameId();
+    for (size_t i = 1; i < ids.size(); ++i) {
+        ids[i] = tf.internFrame("frame_" + std::to_string(i));
+    }
+    
+    std::vector<TransformUpdate> updates;
+    updates.reserve(ids.size());
+    for (size_t i = 1; i < ids.size(); ++i) {
+        updates.emplace_back(ids[topology.parents[i]], ids[i], randomTransform(rng));
+    }
+    tf.applyBatch(updates);
+    return ids;
+}
+
+void runTopology(const Topology& topology, const BenchConfig& config, std::vector<BenchResult>& results) {
+    std::mt19937 rng(42);
+    const size_t frames = topology.parents.size();
+    
+    // 逐条添加整棵树
+    results.push_back(measure("add_transform_build", topology, config, frames - 1, [&]() {
+        TFManager tf;
+        std::vector<FrameId> ids(frames);
+        ids[0] = tf.getWorldFrameId();
+        for (size_t i = 1; i < frames; ++i) {
+            ids[i] = tf.internFrame("frame_" + std::to_string(i));
+            tf.addTransform(ids[topology.parents[i]], ids[i], randomTransform(rng));
+        }
+    }));
+    
+    TFManager tf;
+    const std::vector<FrameId> ids = populate(tf, topology, rng);
+    std::uniform_int_distribution<size_t> pick(0, frames - 1);
+    std::uniform_int_distribution<size_t> pickEdge(1, frames - 1);
+    
+    // 预先生成随机输入，避免把随机数生成计入测试时间
+    constexpr size_t SAMPLE_COUNT = 1024;
+    std::vector<size_t> edges(SAMPLE_COUNT);
+    std::vector<std::pair<size_t, size_t>> pairs(SAMPLE_COUNT);
+    std::vector<Transform> values(SAMPLE_COUNT);
+    for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+        edges[i] = pickEdge(rng);
+        pairs[i] = {pick(rng), pick(rng)};
+        values[i] = randomTransform(rng);
+    }
+    
+    // 更新已存在的边
+    size_t cursor = 0;
+    results.push_back(measure("add_transform_update", topology, config, 1, [&]() {
+        size_t edge = edges[cursor++ % SAMPLE_COUNT];
+        tf.addTransform(ids[topology.parents[edge]], ids[edge], values[cursor % SAMPLE_COUNT]);
+    }));
+    
+    // 批量更新所有边
+    std::vector<TransformUpdate> batch;
+    for (size_t i = 1; i < frames; ++i) {
+        batch.emplace_back(ids[topology.parents[i]], ids[i], values[i % SAMPLE_COUNT]);
+    }
+    results.push_back(measure("apply_batch", topology, config, batch.size(), [&]() {
+        tf.applyBatch(batch);
+    }));
+    
+    // 任意两个坐标系之间的查找
+    results.push_back(measure("lookup_transform", topology, config, SAMPLE_COUNT, [&]() {
+        Transform transform;
+        for (const auto& [target, source] : pairs) {
+            tf.lookupTransform(ids[target], ids[source], transform);
+            consume(transform);
+        }
+    }));
+    
+    // 同一个快照上的查找（每帧渲染的典型用法）
+    results.push_back(measure("snapshot_lookup_transform", topology, config, SAMPLE_COUNT, [&]() {
+        TFSnapshotReader snapshot = tf.acquireSnapshot();
+        Transform transform;
+        for (const auto& [target, source] : pairs) {
+            snapshot->lookupTransform(ids[target], ids[source], transform);
+            consume(transform);
+        }
+    }));
+    
+    // 按时刻查找：所有边都带有时间戳样本
+    {
+        TFManager timed;
+        std::vector<FrameId> timedIds = populate(timed, topology, rng);
+        std::vector<TransformUpdate> samples;
+        for (double stamp : {1.0, 2.0}) {
+            samples.clear();
+            for (size_t i = 1; i < frames; ++i) {
+                samples.emplace_back(timedIds[topology.parents[i]], timedIds[i], values[i % SAMPLE_COUNT], stamp);
+            }
+            timed.applyBatch(samples);
+        }
+        
+        TFSnapshotReader snapshot = timed.acquireSnapshot();
+        results.push_back(measure("snapshot_lookup_transform_timed", topology, config, SAMPLE_COUNT, [&]() {
+            Transform transform;
+            for (const auto& [target, source] : pairs) {
+                snapshot->lookupTransform(timedIds[target], timedIds[source], 1.5, transform);
+                consume(transform);
+            }
+        }));
+    }
+    
+    // 坐标系位置
+    results.push_back(measure("get_frame_position", topology, config, SAMPLE_COUNT, [&]() {
+        for (const auto& pair : pairs) {
+            consume(tf.getFramePosition(ids[pair.first]));
+        }
+    }));
+    
+    // TF连接线数据
+    std::vector<std::pair<glm::vec3, glm::vec3>> connections;
+    results.push_back(measure("get_connections_for_rendering", topology, config, 1, [&]() {
+        tf.getConnectionsForRendering(connections);
+        consume(connections.empty() ? glm::vec3(0.0f) : connections.back().second);
+    }));
+    
+    // 扁平树的整树世界变换传播
+    {
+        FlatTFTree flat;
+        flat.build(*tf.acquireSnapshot());
+        results.push_back(measure("flat_tree_propagate", topology, config, frames, [&]() {
+            flat.computeWorldTransforms();
+            consume(flat.getWorldTransform(frames - 1));
+        }));
+    }
+    
+    // 读写混合：后台线程持续写入，测量读取端的查找开销
+    {
+        std::atomic<bool> stop{false};
+        size_t writes = 0;
+        double writeSeconds = 0.0;
+        std::thread writer([&]() {
+            const auto start = Clock::now();
+            while (!stop.load(std::memory_order_relaxed)) {
+                size_t edge = edges[writes % SAMPLE_COUNT];
+                tf.addTransform(ids[topology.parents[edge]], ids[edge], values[writes % SAMPLE_COUNT]);
+                ++writes;
+            }
+            writeSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        });
+        
+        results.push_back(measure("churn_snapshot_lookup_transform", topology, config, SAMPLE_COUNT, [&]() {
+            TFSnapshotReader snapshot = tf.acquireSnapshot();
+            Transform transform;
+            for (const auto& [target, source] : pairs) {
+                snapshot->lookupTransform(ids[target], ids[source], transform);
+                consume(transform);
+            }
+        }));
+        
+        stop = true;
+        writer.join();
+        results.push_back(BenchResult{"churn_writer_add_transform", topology.name, frames, writes,
+                                      writes ? writeSeconds * 1e9 / writes : 0.0});
+    }
+}
+
+std::string toJson(const std::vector<BenchResult>& results) {
+    std::ostringstream out;
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        out << "    {\"name\": \"" << result.name << "\", "
+            << "\"topology\": \"" << result.topology << "\", "
+            << "\"frames\": " << result.frames << ", "
+            << "\"iterations\": " << result.iterations << ", "
+            << "\"ns_per_op\": " << result.nsPerOp << ", "
+            << "\"ops_per_sec\": " << (result.nsPerOp > 0.0 ? 1e9 / result.nsPerOp : 0.0) << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+} // namespace
+} // namespace mviz
+
+int main(int argc, char* argv[]) {
+    using namespace mviz;
+    
+    BenchConfig config;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            config.minTime = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-frames") == 0 && i + 1 < argc) {
+            config.maxFrames = static_cast<size_t>(std::atoll(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--out file] [--min-time seconds] [--max-frames count]" << std::endl;
+            return 1;
+        }
+    }
+    
+    std::vector<BenchResult> results;
+    std::mt19937 rng(7);
+    for (size_t frames : {size_t(10), size_t(1000), size_t(50000)}) {
+        if (frames > config.maxFrames) continue;
+        
+        for (const Topology& topology : {makeChain(frames), makeStar(frames), makeRandomTree(frames, rng)}) {
+            std::cerr << "Running " << topology.name << " with " << frames << " frames..." << std::endl;
+            runTopology(topology, config, results);
+        }
+    }
+    
+    const std::string json = toJson(results);
+    if (outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream file(outputPath);
+        file << json;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -17,6 +17,7 @@ class Renderer;
 class Camera;
 class SceneManager;
 class UIManager;
+class UploadWorker;
 struct Transform;
 
 class Application {
@@ -132,6 +133,9 @@ private:
     // UI管理器
     std::shared_ptr<UIManager> m_uiManager;
     
+    // 后台上传线程（共享上下文创建失败时为空）
+    std::shared_ptr<UploadWorker> m_uploadWorker;
+    
     // TF管理器 (可能会通过SceneManager使用，但暂时保留向后兼容性)
     std::shared_ptr<TFManager> m_tfManager;
 
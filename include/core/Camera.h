@@ -2,6 +2,7 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include "core/Frustum.h"
 
 namespace mviz {
 
@@ -21,6 +22,9 @@ public:
     // 获取视图和投影矩阵
     glm::mat4 getViewMatrix() const;
     glm::mat4 getProjectionMatrix() const;
+    
+    // 获取视锥体（参考坐标系中），平面顺序和方向见Frustum
+    Frustum getFrustum() const;
 
     // 相机移动方法
     void setPosition(const glm::vec3& position);
@@ -39,6 +43,10 @@ public:
     void setMode(Mode mode);
     Mode getMode() const;
     
+    // 交互状态：鼠标拖动期间为true（即使某一帧没有移动），用于判断相机是否仍在运动
+    void setInteracting(bool interacting) { m_interacting = interacting; }
+    bool isInteracting() const { return m_interacting; }
+    
     // 获取相机属性
     glm::vec3 getPosition() const { return m_position; }
     glm::vec3 getTarget() const { return m_target; }
@@ -77,6 +85,9 @@ private:
     // 相机模式
     Mode m_mode;
     
+    // 是否正在交互
+    bool m_interacting = false;
+    
     // 内部计算方法
     void updateCameraVectors();
     void calculateOrbitPosition();
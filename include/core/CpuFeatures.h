@@ -0,0 +1,28 @@
+#pragma once
+
+namespace mviz {
+
+// 运行时CPU特性检测
+// SIMD代码路径不依赖全局编译选项：只有使用这些指令的函数按目标指令集编译（MVIZ_TARGET_*），
+// 调用前用下面的函数检查当前CPU是否支持，不支持时使用标量实现，程序在任何x86_64 CPU上都能运行。
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MVIZ_X86 1
+#endif
+
+// 为单个函数启用指令集；MSVC不需要编译选项即可使用对应的内建函数
+#if defined(MVIZ_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MVIZ_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define MVIZ_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MVIZ_TARGET_SSSE3
+#define MVIZ_TARGET_AVX2
+#endif
+
+// 当前CPU（及操作系统）是否支持SSSE3，非x86平台返回false；结果在首次调用时缓存
+bool cpuSupportsSSSE3();
+
+// 当前CPU（及操作系统）是否支持AVX2，非x86平台返回false；结果在首次调用时缓存
+bool cpuSupportsAVX2();
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "core/Transform.h"
+
+namespace mviz {
+
+class TFSnapshot;
+
+// 扁平化的TF树
+// 节点按深度分层排列（每层内按句柄排序），父节点总是位于更靠前的层中；
+// 父节点用下标数组表示，平移和旋转按分量分别存放在连续数组中（SoA）。
+// 这样整棵树的世界变换可以按层一次线性遍历求得，同一层内的节点互不依赖，
+// 启用AVX2且CPU支持时每次迭代处理8个节点。适用于上万个坐标系的大型TF树。
+class FlatTFTree {
+public:
+    // 没有父节点时的父节点下标
+    static constexpr int32_t NO_PARENT = -1;
+    
+    // 从快照构建扁平树，拓扑改变后需要重新构建
+    void build(const TFSnapshot& snapshot);
+    
+    // 更新单个坐标系相对于父节点的变换，不改变拓扑；坐标系不在树中时返回false
+    bool setLocalTransform(FrameId frame, const Transform& transform);
+    
+    // 一次线性遍历计算所有节点相对于所在树根节点的变换
+    void computeWorldTransforms();
+    
+    // 查找从source_frame到target_frame的变换，语义与TFManager中的同名函数相同（使用已计算的世界变换）
+    bool lookupTransform(FrameId target_frame, FrameId source_frame, Transform& transform) const;
+    
+    // 节点数量
+    size_t size() const { return m_frames.size(); }
+    
+    // 坐标系对应的节点下标，坐标系不在树中时返回-1
+    int32_t getIndex(FrameId frame) const {
+        return frame.value < m_indices.size() ? m_indices[frame.value] : -1;
+    }
+    
+    // 按节点下标访问
+    FrameId getFrameId(size_t index) const { return m_frames[index]; }
+    int32_t getParentIndex(size_t index) const { return m_parents[index]; }
+    Transform getLocalTransform(size_t index) const;
+    Transform getWorldTransform(size_t index) const;
+    
+private:
+    // 按分量存放的一组变换
+    struct TransformArrays {
+        std::vector<float> tx, ty, tz;
+        std::vector<float> qw, qx, qy, qz;
+        
+        void resize(size_t count);
+        Transform get(size_t index) const;
+        void set(size_t index, const Transform& transform);
+    };
+    
+    // 用父节点的世界变换和本节点的局部变换求本节点的世界变换
+    void propagate(size_t index);
+    
+    // 同时处理从begin开始的8个节点（要求都位于同一层）；AVX2版本只能在cpuSupportsAVX2()为true时调用
+    void propagate8(size_t begin);
+    
+    std::vector<FrameId> m_frames;        // 节点下标 -> 坐标系句柄
+    std::vector<int32_t> m_parents;       // 父节点下标，根节点为NO_PARENT
+    std::vector<int32_t> m_roots;         // 所在树根节点的下标
+    std::vector<size_t> m_levelOffsets;   // 每一层的起始下标，最后一个元素为节点总数
+    std::vector<int32_t> m_indices;       // 坐标系句柄 -> 节点下标
+    
+    TransformArrays m_local;  // 相对于父节点的变换
+    TransformArrays m_world;  // 相对于所在树根节点的变换
+};
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <glm/glm.hpp>
+
+namespace mviz {
+
+// 视锥体，由六个平面表示
+// 每个平面为(a, b, c, d)，点p满足 a*p.x + b*p.y + c*p.z + d >= 0 时位于平面内侧。
+// 从矩阵M中提取的平面位于M的输入空间：用 projection * view 得到世界（参考坐标系）中的视锥体，
+// 用 projection * view * model 得到模型空间中的视锥体，此时可以直接检测模型空间中的包围盒。
+class Frustum {
+public:
+    // 平面顺序
+    enum Plane {
+        LEFT_PLANE = 0,
+        RIGHT_PLANE,
+        BOTTOM_PLANE,
+        TOP_PLANE,
+        NEAR_PLANE,
+        FAR_PLANE,
+        PLANE_COUNT
+    };
+    
+    // 默认构造的视锥体包含所有点
+    Frustum();
+    
+    // 从裁剪矩阵中提取六个平面（Gribb-Hartmann方法），平面已归一化
+    static Frustum fromMatrix(const glm::mat4& clip);
+    
+    // 获取平面
+    const std::array<glm::vec4, PLANE_COUNT>& getPlanes() const { return m_planes; }
+    const glm::vec4& getPlane(Plane plane) const { return m_planes[plane]; }
+    
+    // 检测轴对齐包围盒是否与视锥体相交（保守判断：可能把视锥体外靠近角落的包围盒判为相交）
+    bool intersectsBox(const glm::vec3& min, const glm::vec3& max) const;
+    
+    // 检测点是否在视锥体内
+    bool containsPoint(const glm::vec3& point) const;
+    
+private:
+    std::array<glm::vec4, PLANE_COUNT> m_planes;
+};
+
+// 求轴对齐包围盒经过变换后的轴对齐包围盒
+void transformBox(const glm::mat4& transform, const glm::vec3& min, const glm::vec3& max,
+                  glm::vec3& outMin, glm::vec3& outMax);
+
+} // namespace mviz 
\ No newline at end of file
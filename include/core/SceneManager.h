@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <map>
 #include <string>
@@ -12,7 +14,10 @@ namespace mviz {
 // 前向声明
 class Renderer;
 class Camera;
+class Frustum;
 class PointCloudVisual;
+class RenderTarget;
+class UploadWorker;
 
 // 可视化对象基类
 class VisualObject {
@@ -25,11 +30,43 @@ public:
     // 获取和设置属性
     const std::string& getName() const { return m_name; }
     const std::string& getFrameId() const { return m_frame_id; }
+    
+    // 获取所在坐标系在TF管理器中的句柄，首次调用时驻留坐标系名称
+    FrameId resolveFrameId(TFManager& tf_manager);
     bool isVisible() const { return m_visible; }
     void setVisible(bool visible) { m_visible = visible; }
     
-    // 更新对象的变换和状态
-    virtual void update(TFManager& tf_manager, const std::string& reference_frame);
+    // 数据时间戳（秒），用于查找该时刻的变换，0表示使用最新的变换
+    double getStamp() const { return m_stamp; }
+    void setStamp(double stamp) { m_stamp = stamp; }
+    
+    // 使用本帧的TF快照更新对象的变换和状态（调用前需已解析坐标系句柄）
+    // 对象坐标系和参考坐标系的变换链以及数据时间戳都未改变时跳过查找
+    virtual void update(const TFSnapshot& tf_snapshot, FrameId reference_frame);
+    
+    // 检查上次使用的变换是否仍然有效（两条变换链的版本、参考坐标系和数据时间戳都未改变）
+    bool isTransformCurrent(const TFSnapshot& tf_snapshot, FrameId reference_frame) const;
+    
+    // 使用已查找到的变换更新模型矩阵并记录所用的版本，found为false时重置为单位矩阵
+    void applyTransform(bool found, const Transform& transform, const TFSnapshot& tf_snapshot,
+                        FrameId reference_frame);
+    
+    // 变换从可用变为不可用（坐标系消失或与参考坐标系断开）或恢复可用时调用，每次状态改变只调用一次
+    // 默认在变换不可用时输出一次警告
+    virtual void onTransformAvailabilityChanged(bool available, const TFSnapshot& tf_snapshot,
+                                                FrameId reference_frame);
+    
+    // 更新与变换无关的状态（如GPU缓冲区），在模型矩阵更新之后调用
+    virtual void updateResources() {}
+    
+    // 获取模型矩阵（对象坐标系到参考坐标系）
+    const glm::mat4& getModelMatrix() const { return m_model_matrix; }
+    
+    // 获取对象在自身坐标系中的包围盒，没有有效包围盒（如为空或大小未知）时返回false
+    virtual bool getLocalBounds(glm::vec3& min, glm::vec3& max) const { return false; }
+    
+    // 按模型矩阵变换后的包围盒检测对象是否可能与视锥体相交，没有包围盒时总是返回true
+    bool intersectsFrustum(const Frustum& frustum) const;
     
     // 绘制对象
     virtual void draw(Renderer& renderer, const glm::mat4& view_projection_matrix) = 0;
@@ -37,8 +74,18 @@ public:
 protected:
     std::string m_name;        // 对象名称
     std::string m_frame_id;    // 对象所在的坐标系
+    FrameId m_frame_handle;    // 坐标系句柄，首次更新时解析
     bool m_visible;            // 是否可见
+    double m_stamp;            // 数据时间戳
     glm::mat4 m_model_matrix;  // 模型矩阵
+    
+    // 上次更新模型矩阵时使用的TF状态
+    bool m_transform_applied;         // 是否已经更新过
+    bool m_transform_available;       // 上次查找是否成功
+    uint64_t m_frame_version;         // 对象坐标系的变换链版本
+    uint64_t m_reference_version;     // 参考坐标系的变换链版本
+    FrameId m_reference_handle;       // 参考坐标系句柄
+    double m_applied_stamp;           // 数据时间戳
 };
 
 // 坐标轴可视化对象
@@ -46,7 +93,7 @@ class AxesVisual : public VisualObject {
 public:
     AxesVisual(const std::string& name, const std::string& frame_id, float size = 1.0f);
     
-    void update(TFManager& tf_manager, const std::string& reference_frame) override;
+    void update(const TFSnapshot& tf_snapshot, FrameId reference_frame) override;
     void draw(Renderer& renderer, const glm::mat4& view_projection_matrix) override;
     
 private:
@@ -66,6 +113,10 @@ public:
     void setRenderer(std::shared_ptr<Renderer> renderer);
     void setCamera(std::shared_ptr<Camera> camera);
     
+    // 设置和获取后台上传线程（可以为空），供点云等可视化对象在后台上传数据
+    void setUploadWorker(std::shared_ptr<UploadWorker> worker) { m_upload_worker = std::move(worker); }
+    const std::shared_ptr<UploadWorker>& getUploadWorker() const { return m_upload_worker; }
+    
     // 添加和移除可视化对象
     void addVisualObject(const VisualObject::SharedPtr& object);
     void removeVisualObject(const std::string& name);
@@ -77,6 +128,36 @@ public:
     // 创建示例点云数据
     void createDemoPointCloud();
     
+    // 打开八叉树点云文件（由mviz_octree_convert生成）并添加到场景中，使用当前相机选择LOD
+    bool loadOctreePointCloud(const std::string& name, const std::string& frame_id, const std::string& path);
+    
+    // 设置全局点数预算：每帧按屏幕覆盖面积分给可见的点云，超出分配的点云均匀降采样；0表示不限制
+    void setPointBudget(size_t budget);
+    size_t getPointBudget() const { return m_point_budget; }
+    
+    // 设置目标帧率：帧时间超出目标时逐步降低实际使用的预算，有余量时逐步恢复（不超过设置的预算）；0表示不调整
+    // 开启垂直同步时帧时间不会低于刷新间隔，目标帧率应低于刷新率才能恢复预算
+    void setTargetFrameRate(float fps) { m_target_frame_rate = std::max(fps, 0.0f); }
+    float getTargetFrameRate() const { return m_target_frame_rate; }
+    
+    // 获取本帧实际使用的预算（0表示不限制）和平滑后的帧时间（秒）
+    size_t getEffectivePointBudget() const { return static_cast<size_t>(m_effective_budget); }
+    double getFrameTime() const { return m_frame_time; }
+    
+    // 设置渐进绘制（默认开启）：相机运动时按交互预算绘制点云的均匀子集；相机静止后把支持分段绘制的点云
+    // 分多帧逐段绘制到离屏目标中，画完后每帧只需复制离屏图像，其他对象仍每帧直接绘制
+    void setProgressiveRendering(bool enabled);
+    bool getProgressiveRendering() const { return m_progressive_rendering; }
+    
+    // 设置相机运动时的点数预算（不超过按帧时间调整后的预算），0表示不额外限制
+    void setInteractivePointBudget(size_t budget) { m_interactive_budget = budget; }
+    size_t getInteractivePointBudget() const { return m_interactive_budget; }
+    
+    // 获取渐进绘制的进度：已绘制的段数和总段数（总段数为0表示当前没有在离屏目标中绘制），以及相机是否在运动
+    size_t getProgressivePass() const { return m_progressive_pass; }
+    size_t getProgressivePassCount() const { return m_progressive_passes; }
+    bool isCameraMoving() const { return m_camera_moving; }
+    
     // 设置参考坐标系
     void setReferenceFrame(const std::string& frame);
     const std::string& getReferenceFrame() const { return m_reference_frame; }
@@ -114,15 +195,77 @@ private:
     // TF管理器
     TFManager m_tf_manager;
     
-    // 当前参考坐标系
+    // 本帧使用的TF快照，每帧更新时重新获取，更新和渲染期间保持不变
+    TFSnapshotReader m_tf_snapshot;
+    
+    // 当前参考坐标系及其句柄
     std::string m_reference_frame;
+    FrameId m_reference_frame_id;
     
     // 渲染器和相机引用
     std::shared_ptr<Renderer> m_renderer;
     std::shared_ptr<Camera> m_camera;
     
+    // 后台上传线程
+    std::shared_ptr<UploadWorker> m_upload_worker;
+    
     // 世界坐标轴
     VisualObject::SharedPtr m_world_axes;
+    
+    // 批量TF查找的缓冲区，跨帧复用以避免重复分配
+    std::vector<FrameId> m_batch_frames;
+    std::vector<Transform> m_batch_transforms;
+    std::vector<bool> m_batch_found;
+    std::vector<std::pair<VisualObject*, size_t>> m_batch_objects;
+    
+    // 按坐标系句柄索引的批量查找槽位，用于去重
+    std::vector<size_t> m_frame_slots;
+    
+    // 全局点数预算、目标帧率和按帧时间调整后的预算
+    size_t m_point_budget;
+    float m_target_frame_rate;
+    double m_effective_budget;
+    
+    // 平滑后的帧时间（秒）和上一次渲染的时刻
+    double m_frame_time;
+    std::chrono::steady_clock::time_point m_last_render;
+    
+    // 本帧通过剔除、直接绘制的对象，跨帧复用
+    std::vector<VisualObject*> m_render_list;
+    
+    // 渐进绘制：是否开启、相机运动时的预算、本帧参与渐进绘制的点云
+    bool m_progressive_rendering;
+    size_t m_interactive_budget;
+    std::vector<PointCloudVisual*> m_progressive_list;
+    
+    // 离屏图像对应的点云状态，任一点云的版本号或模型矩阵改变时重新开始绘制
+    struct ProgressiveEntry {
+        const PointCloudVisual* cloud;
+        uint64_t revision;
+        glm::mat4 model;
+    };
+    std::vector<ProgressiveEntry> m_progressive_entries;
+    std::vector<ProgressiveEntry> m_progressive_scratch;
+    
+    // 离屏目标及其对应的视图投影矩阵和视口、已绘制的段数和总段数、相机是否在运动
+    std::unique_ptr<RenderTarget> m_progressive_target;
+    glm::mat4 m_progressive_view_projection;
+    int m_progressive_viewport[4];
+    size_t m_progressive_pass;
+    size_t m_progressive_passes;
+    bool m_camera_moving;
+    
+    // 测量帧时间并调整实际使用的预算
+    void updateFrameTime();
+    
+    // 把预算按屏幕覆盖面积分给m_render_list中的点云
+    void distributePointBudget(const glm::mat4& view_projection, size_t budget);
+    
+    // 判断相机是否在运动、离屏图像是否仍然有效；返回本帧是否使用离屏目标绘制m_progressive_list中的点云
+    bool updateProgressiveState(const glm::mat4& view_projection);
+    
+    // 在离屏目标中绘制下一段（已画完时跳过），再复制到默认帧缓冲区
+    void renderProgressivePass(const glm::mat4& view_projection);
 };
 
 } // namespace mviz 
\ No newline at end of file
@@ -1,48 +1,26 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <string>
-#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <glm/glm.hpp>
-#include <glm/gtc/quaternion.hpp>
+#include "core/Transform.h"
+#include "core/TFSnapshot.h"
 
 namespace mviz {
 
-// 表示一个坐标系变换
-struct Transform {
-    glm::vec3 translation;
-    glm::quat rotation;
-    
-    // 默认构造函数
-    Transform() 
-        : translation(0.0f, 0.0f, 0.0f)
-        , rotation(1.0f, 0.0f, 0.0f, 0.0f) // 单位四元数
-    {}
-    
-    // 带参数构造函数
-    Transform(const glm::vec3& t, const glm::quat& r)
-        : translation(t)
-        , rotation(r)
-    {}
-    
-    // 转换为4x4矩阵
-    glm::mat4 toMat4() const;
-    
-    // 变换组合（右乘）
-    Transform operator*(const Transform& other) const;
-    
-    // 反转变换
-    Transform inverse() const;
-};
-
 // 表示TF树中的一个节点
 class TransformNode {
 public:
-    TransformNode(const std::string& name);
+    TransformNode(FrameId id, const std::string& name);
     ~TransformNode();
     
-    // 获取节点名称
+    // 获取节点句柄和名称
+    FrameId getId() const { return m_id; }
     const std::string& getName() const { return m_name; }
     
     // 设置父节点
@@ -55,7 +33,7 @@ public:
     void addChild(TransformNode* child);
     
     // 删除子节点
-    void removeChild(const std::string& name);
+    void removeChild(const TransformNode* child);
     
     // 获取相对于父节点的变换
     const Transform& getTransform() const { return m_transform; }
@@ -66,55 +44,238 @@ public:
     // 获取子节点列表
     const std::vector<TransformNode*>& getChildren() const { return m_children; }
     
+    // 获取相对于父节点的历史变换缓冲区
+    TransformBuffer& getHistory() { return m_history; }
+    const TransformBuffer& getHistory() const { return m_history; }
+    
+    // 获取相对于所在树根节点的变换（惰性计算并缓存）
+    const Transform& getWorldTransform() const;
+    
+    // 获取所在树的根节点
+    const TransformNode* getRoot() const;
+    
+    // 获取到所在树根节点的边数
+    uint32_t getDepth() const;
+    
+    // 将本节点及其子树的缓存变换标记为失效
+    void invalidateWorldTransform();
+    
 private:
+    // 重新计算缓存的变换（要求父节点缓存有效）
+    void updateWorldTransform() const;
+    
+    FrameId m_id;
     std::string m_name;
     TransformNode* m_parent;
     Transform m_transform;
     std::vector<TransformNode*> m_children;
+    
+    // 带时间戳的历史变换，为空表示该边不随时间变化
+    TransformBuffer m_history;
+    
+    // 缓存的世界变换和根节点，失效时在下次访问时重新计算
+    // 不变式：若节点缓存失效，则其所有子孙节点的缓存也失效
+    mutable Transform m_worldTransform;
+    mutable const TransformNode* m_root;
+    mutable uint32_t m_depth;
+    mutable bool m_worldDirty;
+};
+
+// 批量更新中的一条变换（从parent到child）
+struct TransformUpdate {
+    FrameId parent;
+    FrameId child;
+    Transform transform;
+    double stamp = 0.0;   // 时间戳（秒），不大于0表示该边不随时间变化（会清空其历史记录）
+    
+    TransformUpdate() = default;
+    TransformUpdate(FrameId parent_frame, FrameId child_frame, const Transform& t, double s = 0.0)
+        : parent(parent_frame)
+        , child(child_frame)
+        , transform(t)
+        , stamp(s)
+    {}
 };
 
 // TF管理器类
+// 写入端在内部互斥锁下修改TF树，每次修改后发布一个新的不可变快照（TFSnapshot）。
+// 发布的开销与改变的坐标系（含需要更新的子树）数量成正比，另加复制顶层块表指针的O(坐标系总数 / 4096)。
+// 读取端通过acquireSnapshot()获取当前快照，不加锁，也不会看到修改到一半的树；
+// 旧快照在所有可能持有它的读者释放后才被回收（基于纪元的延迟回收）。
 class TFManager {
 public:
     TFManager();
     ~TFManager();
     
-    // 添加或更新一个变换（从parent_frame到child_frame）
+    // 添加或更新一个变换（从parent_frame到child_frame），该边不随时间变化，会清空其历史记录
     void addTransform(const std::string& parent_frame, const std::string& child_frame, 
                      const Transform& transform);
     
+    // 添加一个静态变换（如传感器安装位置、固定连杆），该边不随时间变化，会清空其历史记录
+    // 快照中连续的静态边被预先组合并挂到最近的动态祖先上，按时刻查找时只需组合动态边；
+    // 父子关系或变换改变时受影响的子树会在发布时重新组合
+    void addStaticTransform(const std::string& parent_frame, const std::string& child_frame,
+                            const Transform& transform);
+    
+    // 添加一个带时间戳（秒）的变换样本，最新的样本同时作为该边的当前变换
+    void addTransform(const std::string& parent_frame, const std::string& child_frame, 
+                     const Transform& transform, double stamp);
+    
+    // 批量添加或更新变换，语义与依次调用addTransform相同，但只发布一个新版本：
+    // 读者要么看到整批更新之前的状态，要么看到之后的状态；开销与批量大小成线性关系
+    void applyBatch(const std::vector<TransformUpdate>& updates);
+    
+    // 设置每条边历史缓冲区保留的最长时长（秒）和最多样本数
+    void setBufferLimits(double max_duration, size_t max_samples);
+    
     // 移除一个变换节点
     void removeTransform(const std::string& frame);
     
-    // 查找从source_frame到target_frame的变换
+    // 获取当前发布的快照，返回的守卫析构前快照保持有效
+    // 不加锁，可在任意线程中调用；同时持有的守卫数量上限为MAX_READERS
+    TFSnapshotReader acquireSnapshot() const;
+    
+    // 获取坐标系名称对应的句柄，名称尚未驻留时分配新句柄（坐标系本身不会被创建）
+    FrameId internFrame(const std::string& frame);
+    
+    // 查找坐标系名称对应的句柄，名称尚未驻留时返回无效句柄
+    FrameId findFrameId(const std::string& frame) const { return m_frameNames.find(frame); }
+    
+    // 获取句柄对应的坐标系名称
+    const std::string& getFrameName(FrameId frame) const { return m_frameNames.getName(frame); }
+    
+    // 已分配的句柄数量，所有有效句柄的value都小于该值
+    size_t getFrameIdCount() const { return m_frameNames.size(); }
+    
+    // 检查坐标系当前是否存在于TF树中
+    bool hasFrame(FrameId frame) const { return acquireSnapshot()->hasFrame(frame); }
+    
+    // 获取坐标系在当前快照中的变换链版本，见TFSnapshot::getFrameVersion
+    uint64_t getFrameVersion(FrameId frame) const { return acquireSnapshot()->getFrameVersion(frame); }
+    
+    // 世界坐标系句柄
+    FrameId getWorldFrameId() const { return m_worldFrame; }
+    
+    // 以下为使用句柄的重载，语义与对应的字符串版本相同
+    void addTransform(FrameId parent_frame, FrameId child_frame, const Transform& transform);
+    void addTransform(FrameId parent_frame, FrameId child_frame, const Transform& transform, double stamp);
+    void addStaticTransform(FrameId parent_frame, FrameId child_frame, const Transform& transform);
+    void removeTransform(FrameId frame);
+    bool lookupTransform(FrameId target_frame, FrameId source_frame, Transform& transform) const;
+    bool lookupTransform(FrameId target_frame, FrameId source_frame, double time, Transform& transform) const;
+    size_t lookupTransforms(FrameId target_frame, const std::vector<FrameId>& source_frames,
+                            std::vector<Transform>& transforms, std::vector<bool>& found) const;
+    size_t lookupTransforms(FrameId target_frame, const std::vector<FrameId>& source_frames,
+                            double time, std::vector<Transform>& transforms, std::vector<bool>& found) const;
+    glm::vec3 getFramePosition(FrameId frame) const;
+    
+    // 查找从source_frame到target_frame的变换，即把source_frame下的坐标变换到target_frame下
+    // 结果为 inverse(W_target) * W_source，W为缓存的节点世界变换
     bool lookupTransform(const std::string& target_frame, const std::string& source_frame,
                         Transform& transform) const;
     
-    // 获取所有坐标系名称
+    // 查找指定时刻（秒）从source_frame到target_frame的变换，沿路径对每条边的历史样本插值
+    // time <= 0 表示使用最新的变换；任意一条边无法覆盖该时刻时返回false
+    bool lookupTransform(const std::string& target_frame, const std::string& source_frame,
+                        double time, Transform& transform) const;
+    
+    // 批量查找：把多个source_frame变换到同一个target_frame
+    // 目标坐标系只解析一次，源坐标系之间共享祖先的部分变换乘积会被复用
+    // transforms和found与source_frames一一对应，返回成功查找的数量
+    size_t lookupTransforms(const std::string& target_frame, const std::vector<std::string>& source_frames,
+                            std::vector<Transform>& transforms, std::vector<bool>& found) const;
+    
+    // 批量查找指定时刻（秒）的变换，time <= 0 表示使用最新的变换
+    size_t lookupTransforms(const std::string& target_frame, const std::vector<std::string>& source_frames,
+                            double time, std::vector<Transform>& transforms, std::vector<bool>& found) const;
+    
+    // 获取所有坐标系名称（按名称排序）
     std::vector<std::string> getAllFrameNames() const;
     
+    // 获取所有坐标系句柄
+    std::vector<FrameId> getAllFrameIds() const;
+    
     // 获取指定坐标系的位置（在世界坐标系下）
     glm::vec3 getFramePosition(const std::string& frame) const;
     
     // 获取图可视化的数据：起点、终点和标签
     void getConnectionsForRendering(std::vector<std::pair<glm::vec3, glm::vec3>>& connections) const;
     
+    // 可同时持有快照的读者数量上限
+    static constexpr size_t MAX_READERS = 64;
+    
 private:
     // 查找节点，如果不存在则创建
-    TransformNode* findOrCreateNode(const std::string& name);
+    TransformNode* findOrCreateNode(FrameId id);
+    
+    // 按句柄查找节点，句柄无效或节点已移除时返回nullptr
+    TransformNode* getNode(FrameId id) const {
+        return id.value < m_nodes.size() ? m_nodes[id.value].get() : nullptr;
+    }
+    
+    // 应用一条变换更新，stamped为false时该边不随时间变化（要求持有写锁，不发布）
+    void applyUpdate(FrameId parent_frame, FrameId child_frame, const Transform& transform,
+                     bool stamped, double stamp);
+    
+    // 记录一个需要写入下一个快照的坐标系，subtree为true时其整个子树都需要更新
+    void markChanged(FrameId id, bool subtree);
     
-    // 查找节点
-    TransformNode* findNode(const std::string& name) const;
+    // 根据记录的修改构建并发布新快照，回收不再被读者持有的旧快照（要求持有写锁）
+    void publish();
     
-    // 计算从source到target的路径，返回沿路径的变换序列和方向
-    bool findTransformPath(const TransformNode* target, const TransformNode* source,
-                          std::vector<std::pair<const TransformNode*, bool>>& path) const;
+    // 获取下一个快照中可写的坐标系状态，所在的块表和块在本次发布中首次写入时复制
+    TFFrameState& writableFrame(TFSnapshot& snapshot, FrameId id);
     
-    // 世界坐标系节点
+    // 回收所有读者都已不再持有的旧快照（要求持有写锁）
+    void reclaimSnapshots();
+    
+    // 把多个坐标系名称转换为句柄
+    std::vector<FrameId> findFrameIds(const std::vector<std::string>& frames) const;
+    
+    // 检查把child挂到parent下是否会形成环：child没有子节点时O(1)，父子关系自上次发布以来未改变时O(log N)
+    bool wouldCreateCycle(const TransformNode* parent, const TransformNode* child) const;
+    
+    // 坐标系名称驻留表
+    FrameNameTable m_frameNames;
+    
+    // 所有坐标系节点，按句柄编号稠密存储，已移除或尚未创建的位置为nullptr
+    std::vector<std::unique_ptr<TransformNode>> m_nodes;
+    
+    // 世界坐标系节点及其句柄
     TransformNode* m_worldNode;
+    FrameId m_worldFrame;
+    
+    // 历史缓冲区限制
+    double m_bufferDuration;
+    size_t m_bufferMaxSamples;
+    
+    // 写入端互斥锁，只在写入端之间互斥，读者从不获取
+    std::mutex m_writeMutex;
+    
+    // 等待发布的修改：坐标系句柄以及是否需要更新整个子树
+    std::vector<std::pair<FrameId, bool>> m_pendingChanges;
+    
+    // 自上次发布以来是否有坐标系的父节点改变（此时快照中的祖先关系已过时）
+    bool m_topologyChanged;
+    
+    // 发布时按句柄记录的去重标记（版本号 * 2 + 是否已更新子树）
+    std::vector<uint64_t> m_changeMarks;
+    
+    // 每个块表和存储块在哪个版本中被复制过，同一次发布中只复制一次
+    std::vector<uint64_t> m_tableVersions;
+    std::vector<uint64_t> m_chunkVersions;
+    
+    // 当前发布的快照
+    std::atomic<const TFSnapshot*> m_current;
+    
+    // 发布纪元，每次发布后递增
+    mutable std::atomic<uint64_t> m_epoch;
+    
+    // 读者槽位
+    mutable std::array<TFReaderSlot, MAX_READERS> m_readerSlots;
     
-    // 所有坐标系节点的映射表
-    std::map<std::string, std::unique_ptr<TransformNode>> m_nodes;
+    // 已被替换但可能仍有读者持有的快照，以及替换时的纪元
+    std::vector<std::pair<uint64_t, const TFSnapshot*>> m_retired;
 };
 
 } // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "core/Transform.h"
+
+namespace mviz {
+
+class TFManager;
+
+// 快照中单个坐标系的状态
+struct TFFrameState {
+    bool exists = false;    // 坐标系是否存在于TF树中
+    FrameId id;             // 坐标系句柄
+    FrameId parent;         // 父坐标系，根节点为无效句柄
+    FrameId root;           // 所在树的根坐标系
+    uint32_t depth = 0;     // 到根节点的边数
+    FrameId jump;           // 跳跃指针：某个祖先（根节点指向自身），用于O(log N)的祖先查询
+    Transform transform;    // 相对于父坐标系的当前变换
+    Transform world;        // 相对于根坐标系的变换
+    TransformBuffer history; // 相对于父坐标系的历史变换，为空表示该边不随时间变化
+    FrameId staticBase;     // 最近的“到父节点的边随时间变化”的祖先（含自身），没有时为根节点
+    Transform staticOffset; // 从staticBase到本坐标系的变换，即中间各条静态边预先组合的结果
+    uint64_t version = 0;   // 该坐标系或其任一祖先最后一次改变（含出现和消失）时的快照版本
+    
+    // 获取指定时刻相对于父坐标系的变换，没有历史记录的边对任意时刻都返回当前变换
+    bool getTransformAt(double stamp, Transform& result) const;
+};
+
+// TF树的不可变快照
+// 由TFManager在每次修改后发布，发布后不再修改，可在任意线程中无锁读取。
+// 坐标系状态按句柄分块存储，块再按TABLE_SIZE个一组放在块表中，形成两级结构；
+// 相邻版本之间未修改的块和块表共享同一份内存，发布时只复制顶层的块表指针和包含修改的块表与块。
+class TFSnapshot {
+public:
+    // 每个存储块包含的坐标系数量
+    static constexpr size_t CHUNK_SIZE = 64;
+    
+    // 每个块表包含的块数量（即每个块表覆盖CHUNK_SIZE * TABLE_SIZE个坐标系）
+    static constexpr size_t TABLE_SIZE = 64;
+    
+    // 快照版本号，每次发布递增
+    uint64_t getVersion() const { return m_version; }
+    
+    // 获取坐标系状态，坐标系不存在时返回nullptr
+    const TFFrameState* getFrame(FrameId frame) const;
+    
+    // 检查坐标系是否存在
+    bool hasFrame(FrameId frame) const { return getFrame(frame) != nullptr; }
+    
+    // 获取坐标系的变换链版本：坐标系本身或任一祖先的变换、历史、父子关系改变，以及坐标系出现或消失时都会增大
+    // 从未出现过的坐标系返回0；变换链版本不变时，该坐标系到其他坐标系的变换只取决于对方的变换链
+    uint64_t getFrameVersion(FrameId frame) const;
+    
+    // 世界坐标系句柄
+    FrameId getWorldFrameId() const { return m_world; }
+    
+    // 名称与句柄的转换（坐标系名称驻留表在所有版本之间共享）
+    FrameId findFrameId(const std::string& frame) const { return m_frameNames->find(frame); }
+    const std::string& getFrameName(FrameId frame) const { return m_frameNames->getName(frame); }
+    
+    // 获取坐标系在指定深度上的祖先（depth不大于坐标系自身深度），O(log N)且不分配内存
+    FrameId getAncestorAtDepth(FrameId frame, uint32_t depth) const;
+    
+    // 获取两个坐标系的最近公共祖先，不存在或不在同一棵树中时返回无效句柄，O(log N)且不分配内存
+    FrameId findCommonAncestor(FrameId frame_a, FrameId frame_b) const;
+    
+    // 查找从source_frame到target_frame的变换，语义与TFManager中的同名函数相同
+    bool lookupTransform(FrameId target_frame, FrameId source_frame, Transform& transform) const;
+    bool lookupTransform(FrameId target_frame, FrameId source_frame, double time, Transform& transform) const;
+    size_t lookupTransforms(FrameId target_frame, const std::vector<FrameId>& source_frames,
+                            std::vector<Transform>& transforms, std::vector<bool>& found) const;
+    size_t lookupTransforms(FrameId target_frame, const std::vector<FrameId>& source_frames,
+                            double time, std::vector<Transform>& transforms, std::vector<bool>& found) const;
+    
+    // 获取坐标系在世界坐标系下的位置，不存在或与世界坐标系不连通时返回原点
+    glm::vec3 getFramePosition(FrameId frame) const;
+    
+    // 获取所有存在的坐标系句柄和名称（名称按字典序排序）
+    std::vector<FrameId> getAllFrameIds() const;
+    std::vector<std::string> getAllFrameNames() const;
+    
+    // 获取图可视化的数据：父坐标系和子坐标系在世界坐标系下的位置
+    void getConnectionsForRendering(std::vector<std::pair<glm::vec3, glm::vec3>>& connections) const;
+    
+private:
+    friend class TFManager;
+    
+    // 固定大小的坐标系状态块
+    struct Chunk {
+        std::array<TFFrameState, CHUNK_SIZE> frames;
+    };
+    
+    // 块表，nullptr表示该块内没有坐标系
+    struct ChunkTable {
+        std::array<std::shared_ptr<Chunk>, TABLE_SIZE> chunks;
+    };
+    
+    // 按块下标获取块，不存在时返回nullptr
+    const Chunk* getChunk(size_t index) const;
+    
+    // 从frame向上走到ancestor，把沿途各边在指定时刻的变换累积为ancestor到frame的变换
+    // 连续的静态边使用预先组合的变换，只有随时间变化的边需要插值
+    bool accumulateToAncestor(const TFFrameState* frame, const TFFrameState* ancestor, double time,
+                              Transform& result) const;
+    
+    // 按跳跃指针向上走到指定深度的祖先
+    const TFFrameState* climbToDepth(const TFFrameState* frame, uint32_t depth) const;
+    
+    explicit TFSnapshot(const FrameNameTable* frame_names) : m_frameNames(frame_names) {}
+    TFSnapshot(const TFSnapshot&) = default;
+    
+    const FrameNameTable* m_frameNames;
+    
+    // 按句柄分块的坐标系状态的块表，nullptr表示该块表内没有坐标系；发布后块表和块的内容不再修改
+    std::vector<std::shared_ptr<ChunkTable>> m_tables;
+    
+    uint64_t m_version = 0;
+    FrameId m_world;
+};
+
+// 读者槽位：记录读者持有快照时观察到的发布纪元
+struct alignas(64) TFReaderSlot {
+    std::atomic<bool> active{false};
+    std::atomic<uint64_t> epoch{0};
+};
+
+// 快照读取守卫
+// 持有期间对应的快照不会被回收；析构或reset()后快照指针失效。只能移动，不能复制。
+class TFSnapshotReader {
+public:
+    TFSnapshotReader() = default;
+    TFSnapshotReader(TFReaderSlot* slot, const TFSnapshot* snapshot)
+        : m_slot(slot)
+        , m_snapshot(snapshot)
+    {}
+    ~TFSnapshotReader() { reset(); }
+    
+    TFSnapshotReader(TFSnapshotReader&& other) noexcept
+        : m_slot(other.m_slot)
+        , m_snapshot(other.m_snapshot)
+    {
+        other.m_slot = nullptr;
+        other.m_snapshot = nullptr;
+    }
+    
+    TFSnapshotReader& operator=(TFSnapshotReader&& other) noexcept {
+        if (this != &other) {
+            reset();
+            m_slot = other.m_slot;
+            m_snapshot = other.m_snapshot;
+            other.m_slot = nullptr;
+            other.m_snapshot = nullptr;
+        }
+        return *this;
+    }
+    
+    TFSnapshotReader(const TFSnapshotReader&) = delete;
+    TFSnapshotReader& operator=(const TFSnapshotReader&) = delete;
+    
+    // 释放快照
+    void reset() {
+        if (m_slot) {
+            m_slot->active.store(false);
+            m_slot = nullptr;
+        }
+        m_snapshot = nullptr;
+    }
+    
+    const TFSnapshot* get() const { return m_snapshot; }
+    const TFSnapshot* operator->() const { return m_snapshot; }
+    const TFSnapshot& operator*() const { return *m_snapshot; }
+    explicit operator bool() const { return m_snapshot != nullptr; }
+    
+private:
+    TFReaderSlot* m_slot = nullptr;
+    const TFSnapshot* m_snapshot = nullptr;
+};
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace mviz {
+
+// 表示一个坐标系变换
+struct Transform {
+    glm::vec3 translation;
+    glm::quat rotation;
+    
+    // 默认构造函数
+    Transform()
+        : translation(0.0f, 0.0f, 0.0f)
+        , rotation(1.0f, 0.0f, 0.0f, 0.0f) // 单位四元数
+    {}
+    
+    // 带参数构造函数
+    Transform(const glm::vec3& t, const glm::quat& r)
+        : translation(t)
+        , rotation(r)
+    {}
+    
+    // 转换为4x4矩阵
+    glm::mat4 toMat4() const;
+    
+    // 变换组合（右乘）
+    Transform operator*(const Transform& other) const;
+    
+    // 反转变换
+    Transform inverse() const;
+    
+    // 在两个变换之间插值（平移线性插值，旋转球面插值），ratio取值[0, 1]
+    static Transform interpolate(const Transform& from, const Transform& to, float ratio);
+};
+
+// 单条TF边的历史变换缓冲区
+// 样本按时间戳排序存放在连续内存中，按时长和样本数上限淘汰旧样本。
+// 存储块只在尾部追加、已写入的样本不再修改，因此缓冲区的拷贝只共享存储块而不复制样本，
+// 快照中保存的拷贝在写入端继续追加时依然有效。
+class TransformBuffer {
+public:
+    // 带时间戳的变换样本
+    struct Sample {
+        double stamp;         // 时间戳（秒）
+        Transform transform;  // 该时刻相对于父节点的变换
+    };
+    
+    // 默认保留的最长时长（秒）和最多样本数
+    static constexpr double DEFAULT_MAX_DURATION = 10.0;
+    static constexpr size_t DEFAULT_MAX_SAMPLES = 1024;
+    
+    TransformBuffer();
+    
+    // 设置缓冲区保留的最长时长（秒）和最多样本数
+    void setLimits(double max_duration, size_t max_samples);
+    
+    // 插入一个样本，时间戳相同的样本会被覆盖
+    void insert(double stamp, const Transform& transform);
+    
+    // 查找指定时刻的变换，位于两个样本之间时进行插值
+    // 只有一个样本时对任意时刻有效；超出缓冲区时间范围时返回false
+    bool lookup(double stamp, Transform& transform) const;
+    
+    // 清空缓冲区
+    void clear();
+    
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    
+    // 最旧和最新样本（要求缓冲区非空）
+    const Sample& oldest() const { return at(0); }
+    const Sample& newest() const { return at(m_count - 1); }
+    
+private:
+    // 样本存储块，容量固定，used之前的样本一经写入不再修改
+    struct Block {
+        std::vector<Sample> samples;
+        size_t used = 0;
+    };
+    
+    // 按逻辑下标（0为最旧样本）访问
+    const Sample& at(size_t index) const { return m_block->samples[m_begin + index]; }
+    
+    // 二分查找第一个时间戳不小于stamp的样本的逻辑下标
+    size_t lowerBound(double stamp) const;
+    
+    // 把当前样本复制到新的存储块，并在position处插入sample（position为size()时追加）
+    void rebuild(size_t position, const Sample& sample);
+    
+    // 按样本数和时长上限淘汰旧样本
+    void evict();
+    
+    std::shared_ptr<Block> m_block;
+    size_t m_begin;   // 最旧样本在存储块中的位置
+    size_t m_count;   // 有效样本数
+    double m_maxDuration;
+    size_t m_maxSamples;
+};
+
+// 坐标系句柄：坐标系名称驻留后得到的整数编号，热路径上用它代替字符串
+struct FrameId {
+    static constexpr uint32_t INVALID = UINT32_MAX;
+    
+    uint32_t value = INVALID;
+    
+    FrameId() = default;
+    explicit FrameId(uint32_t v) : value(v) {}
+    
+    bool isValid() const { return value != INVALID; }
+    bool operator==(const FrameId& other) const { return value == other.value; }
+    bool operator!=(const FrameId& other) const { return value != other.value; }
+};
+
+// 坐标系名称驻留表：名称与FrameId一一对应，编号从0开始连续分配且不会改变
+// 可在多个线程中同时使用；名称字符串的地址在表的生命周期内保持不变
+class FrameNameTable {
+public:
+    // 查找名称对应的句柄，不存在时分配一个新句柄
+    FrameId intern(const std::string& name);
+    
+    // 查找名称对应的句柄，不存在时返回无效句柄
+    FrameId find(const std::string& name) const;
+    
+    // 获取句柄对应的名称
+    const std::string& getName(FrameId id) const;
+    
+    // 已分配的句柄数量
+    size_t size() const;
+    
+private:
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::string, FrameId> m_ids;
+    std::vector<const std::string*> m_names; // 指向m_ids中的键，节点地址稳定
+};
+
+} // namespace mviz 
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "data/PointAttributes.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
@@ -8,18 +10,26 @@
 namespace mviz {
 
 /**
- * 点云数据结构
+ * 点云数据结构（按属性分开存储）
+ * 位置和颜色是固定的通道，其他字段（强度、线束编号、标签、时间戳、法向量等）存放在按名称查找的属性通道中，
+ * 每个通道是一块64字节对齐的连续存储；绘制时只上传当前着色器需要的通道
  */
 struct PointCloudData {
     std::vector<glm::vec3> points;
     std::vector<glm::vec3> colors;  // RGB颜色，每个点一个
+    
+    // 其他属性通道（均可选），常用名称见PointAttributes.h
+    std::vector<PointAttribute> attributes;
+    
     float pointSize = 1.0f;
+    double stamp = 0.0;             // 采集时间戳（秒），0表示使用最新的变换
     
     PointCloudData() = default;
     
     void clear() {
         points.clear();
         colors.clear();
+        attributes.clear();
     }
     
     size_t size() const {
@@ -29,6 +39,32 @@ struct PointCloudData {
     bool empty() const {
         return points.empty();
     }
+    
+    // 按名称查找属性通道，不存在时返回nullptr
+    PointAttribute* findAttribute(const std::string& name) {
+        for (PointAttribute& attribute : attributes) {
+            if (attribute.getName() == name) {
+                return &attribute;
+            }
+        }
+        return nullptr;
+    }
+    
+    const PointAttribute* findAttribute(const std::string& name) const {
+        return const_cast<PointCloudData*>(this)->findAttribute(name);
+    }
+    
+    // 添加属性通道；同名通道已存在时替换为新的空通道
+    // 返回的引用在添加其他通道后可能失效
+    PointAttribute& addAttribute(const std::string& name, AttributeType type, size_t components = 1) {
+        PointAttribute* existing = findAttribute(name);
+        if (existing) {
+            *existing = PointAttribute(name, type, components);
+            return *existing;
+        }
+        attributes.emplace_back(name, type, components);
+        return attributes.back();
+    }
 };
 
 /**
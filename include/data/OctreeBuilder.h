@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace mviz {
+
+// 八叉树转换的输入点源，需要支持多次从头读取（转换过程读取两遍）
+class OctreePointSource {
+public:
+    virtual ~OctreePointSource() = default;
+    
+    // 是否提供颜色
+    virtual bool hasColors() const = 0;
+    
+    // 回到第一个点，失败时返回false
+    virtual bool rewind() = 0;
+    
+    // 读取最多maxCount个点追加到points和colors（[0, 1]的RGB，仅hasColors），返回读取的点数，0表示结束
+    virtual size_t read(std::vector<glm::vec3>& points, std::vector<glm::vec3>& colors, size_t maxCount) = 0;
+};
+
+// 转换选项
+struct OctreeBuildOptions {
+    uint32_t gridSize = 128;           // 每个节点的采样网格分辨率（每个轴）
+    uint32_t maxLeafPoints = 20000;    // 剩余点数不超过此值时不再细分
+    uint32_t maxDepth = 24;            // 最大深度
+    uint64_t maxBucketPoints = 4000000; // 外存分区的每个分区的平均点数上限，决定一次载入内存的点数
+    std::string tempDirectory;         // 临时分区文件所在目录，为空时使用输出文件名加".tmp"
+};
+
+// 转换统计
+struct OctreeBuildStats {
+    uint64_t inputPoints = 0;
+    uint64_t outputPoints = 0;
+    uint32_t nodeCount = 0;
+    uint32_t depth = 0;
+    uint32_t bucketLevel = 0;
+};
+
+// 把任意规模的点云转换为八叉树文件（格式见OctreeFile.h）
+// 第一遍读取求包围盒；第二遍自顶向下采样前bucketLevel层，其余的点按所在的第bucketLevel层节点写入临时分区文件；
+// 最后逐个载入分区，在内存中递归采样和细分。内存占用取决于单个分区的点数，与输入总点数无关。
+bool buildOctree(OctreePointSource& source, const std::string& outputPath, const OctreeBuildOptions& options,
+                 OctreeBuildStats* stats = nullptr);
+
+} // namespace mviz 
\ No newline at end of file
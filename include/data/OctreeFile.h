@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <glm/glm.hpp>
+
+namespace mviz {
+
+// 八叉树点云文件（由mviz_octree_convert生成）
+// 文件布局（小端）：[OctreeFileHeader][各节点的点数据][OctreeNodeRecord x nodeCount]
+// 每个节点保存对其所在立方体的一次网格采样，子节点只包含父节点没有保存的点（叠加式LOD），
+// 绘制时父节点和已加载的子节点一起绘制。根节点的下标为0。
+// 节点的点数据：[int16位置 x 4 x count][RGBA8颜色 x count（仅hasColors）]，
+// 位置相对于节点立方体量化，解码参数由computeQuantization(min, min + size)求出。
+
+constexpr char OCTREE_FILE_MAGIC[8] = {'M', 'V', 'I', 'Z', 'O', 'C', 'T', '1'};
+constexpr uint32_t OCTREE_FILE_VERSION = 1;
+
+// 每个点的量化位置占用的字节数
+constexpr size_t OCTREE_POSITION_BYTES = 4 * sizeof(int16_t);
+
+struct OctreeFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nodeCount;
+    uint64_t pointCount;       // 所有节点的点数之和
+    uint64_t nodeTableOffset;  // 节点表的字节偏移
+    float min[3];              // 根节点立方体的最小角点
+    float size;                // 根节点立方体的边长
+    float spacing;             // 根节点的采样间距（网格单元边长），第n层为spacing / 2^n
+    uint32_t hasColors;
+};
+
+struct OctreeNodeRecord {
+    uint64_t dataOffset;  // 点数据的字节偏移
+    uint32_t pointCount;
+    uint8_t level;        // 深度，根节点为0
+    uint8_t childMask;    // 第i位表示存在第i个子节点（i的第0/1/2位对应x/y/z的上半部分）
+    uint16_t reserved;
+    int32_t children[8];  // 子节点下标，不存在时为-1
+    float min[3];         // 节点立方体的最小角点
+    float size;           // 节点立方体的边长
+};
+
+static_assert(sizeof(OctreeFileHeader) == 56, "unexpected octree header layout");
+static_assert(sizeof(OctreeNodeRecord) == 64, "unexpected octree node layout");
+
+// 节点点数据的字节数
+inline size_t octreeNodeBytes(uint32_t pointCount, bool hasColors) {
+    return pointCount * (OCTREE_POSITION_BYTES + (hasColors ? sizeof(uint32_t) : 0));
+}
+
+// 只读映射的八叉树文件
+// 整个文件映射到内存，节点数据在首次访问时才由系统从磁盘读入；可以在多个线程中同时读取。
+class OctreeFile {
+public:
+    OctreeFile();
+    ~OctreeFile();
+    
+    OctreeFile(const OctreeFile&) = delete;
+    OctreeFile& operator=(const OctreeFile&) = delete;
+    
+    // 映射并校验文件，失败时输出错误并返回false
+    bool open(const std::string& path);
+    
+    // 解除映射
+    void close();
+    
+    bool isOpen() const { return m_data != nullptr; }
+    const std::string& getPath() const { return m_path; }
+    
+    // 文件头和节点表（指向映射的内存）
+    const OctreeFileHeader& getHeader() const { return *m_header; }
+    const OctreeNodeRecord& getNode(size_t index) const { return m_nodes[index]; }
+    size_t getNodeCount() const { return m_header ? m_header->nodeCount : 0; }
+    bool hasColors() const { return m_header && m_header->hasColors != 0; }
+    
+    // 节点的点数据及其字节数；返回的指针在文件关闭前有效，首次读取可能阻塞于磁盘IO
+    const uint8_t* getNodeData(size_t index) const { return m_data + m_nodes[index].dataOffset; }
+    size_t getNodeDataSize(size_t index) const { return octreeNodeBytes(m_nodes[index].pointCount, hasColors()); }
+    
+    // 节点的采样间距
+    float getNodeSpacing(size_t index) const;
+    
+    // 提示系统预读节点数据（不阻塞）
+    void prefetch(size_t index) const;
+    
+private:
+    std::string m_path;
+    const uint8_t* m_data;
+    size_t m_size;
+    const OctreeFileHeader* m_header;
+    const OctreeNodeRecord* m_nodes;
+
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#else
+    int m_fd;
+#endif
+};
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mviz {
+
+// 常用属性通道的名称
+constexpr const char* ATTRIBUTE_INTENSITY = "intensity"; // 反射强度（FLOAT32）
+constexpr const char* ATTRIBUTE_RING = "ring";           // 激光线束编号（UINT16）
+constexpr const char* ATTRIBUTE_LABEL = "label";         // 语义标签（UINT16）
+constexpr const char* ATTRIBUTE_TIMESTAMP = "timestamp"; // 每个点的采集时间（FLOAT64，秒）
+constexpr const char* ATTRIBUTE_NORMAL = "normal";       // 法向量（FLOAT32 x 3）
+
+/**
+ * 属性分量的数据类型
+ */
+enum class AttributeType {
+    UINT8,
+    UINT16,
+    UINT32,
+    INT32,
+    FLOAT32,
+    FLOAT64
+};
+
+// 数据类型的字节数
+size_t attributeTypeSize(AttributeType type);
+
+// 数据类型是否为整数
+bool isIntegerAttributeType(AttributeType type);
+
+// C++类型对应的属性类型
+template <typename T> struct AttributeTypeOf;
+template <> struct AttributeTypeOf<uint8_t> { static constexpr AttributeType value = AttributeType::UINT8; };
+template <> struct AttributeTypeOf<uint16_t> { static constexpr AttributeType value = AttributeType::UINT16; };
+template <> struct AttributeTypeOf<uint32_t> { static constexpr AttributeType value = AttributeType::UINT32; };
+template <> struct AttributeTypeOf<int32_t> { static constexpr AttributeType value = AttributeType::INT32; };
+template <> struct AttributeTypeOf<float> { static constexpr AttributeType value = AttributeType::FLOAT32; };
+template <> struct AttributeTypeOf<double> { static constexpr AttributeType value = AttributeType::FLOAT64; };
+
+/**
+ * 点的属性通道
+ * 有名称、分量类型和每点分量数，各点的值紧密排列；存储的起始地址按64字节（缓存行）对齐，
+ * 容量按64字节取整，便于SIMD整块读取和直接拷贝到GPU缓冲区
+ */
+class PointAttribute {
+public:
+    // 存储的对齐字节数
+    static constexpr size_t ALIGNMENT = 64;
+    
+    /**
+     * 构造函数
+     * @param name 属性名称
+     * @param type 分量类型
+     * @param components 每点的分量数
+     */
+    PointAttribute(std::string name, AttributeType type, size_t components = 1);
+    
+    PointAttribute(const PointAttribute& other);
+    PointAttribute& operator=(const PointAttribute& other);
+    PointAttribute(PointAttribute&& other) noexcept = default;
+    PointAttribute& operator=(PointAttribute&& other) noexcept = default;
+    
+    /**
+     * 获取属性名称
+     * @return 名称
+     */
+    const std::string& getName() const { return m_name; }
+    
+    /**
+     * 获取分量类型
+     * @return 分量类型
+     */
+    AttributeType getType() const { return m_type; }
+    
+    /**
+     * 获取每点的分量数
+     * @return 分量数
+     */
+    size_t getComponents() const { return m_components; }
+    
+    /**
+     * 获取每点占用的字节数
+     * @return 字节数
+     */
+    size_t getElementSize() const { return attributeTypeSize(m_type) * m_components; }
+    
+    /**
+     * 获取点数
+     * @return 点数
+     */
+    size_t size() const { return m_size; }
+    
+    /**
+     * 是否没有数据
+     * @return 是否为空
+     */
+    bool empty() const { return m_size == 0; }
+    
+    /**
+     * 改变点数，新增的点的值为0
+     * @param count 点数
+     */
+    void resize(size_t count);
+    
+    /**
+     * 预留存储
+     * @param count 点数
+     */
+    void reserve(size_t count);
+    
+    /**
+     * 清空数据（保留存储）
+     */
+    void clear() { m_size = 0; }
+    
+    /**
+     * 追加一个点的值，T的大小必须等于每点的字节数（如3分量FLOAT32可以使用glm::vec3）
+     * @param value 值
+     */
+    template <typename T>
+    void push_back(const T& value) {
+        assert(sizeof(T) == getElementSize());
+        if (m_size == m_capacity) {
+            reserve(m_capacity > 0 ? m_capacity * 2 : 64);
+        }
+        reinterpret_cast<T*>(m_data.get())[m_size++] = value;
+    }
+    
+    /**
+     * 按类型访问数据，T必须与分量类型一致
+     * @return 第一个点的第一个分量
+     */
+    template <typename T>
+    T* data() {
+        assert(AttributeTypeOf<T>::value == m_type);
+        return reinterpret_cast<T*>(m_data.get());
+    }
+    
+    template <typename T>
+    const T* data() const {
+        assert(AttributeTypeOf<T>::value == m_type);
+        return reinterpret_cast<const T*>(m_data.get());
+    }
+    
+    /**
+     * 获取原始数据（按64字节对齐）
+     * @return 数据起始地址，没有分配存储时为nullptr
+     */
+    void* rawData() { return m_data.get(); }
+    const void* rawData() const { return m_data.get(); }
+    
+private:
+    struct AlignedDeleter {
+        void operator()(uint8_t* data) const;
+    };
+    
+    std::string m_name;
+    AttributeType m_type;
+    size_t m_components;
+    std::unique_ptr<uint8_t[], AlignedDeleter> m_data;
+    size_t m_size;     // 点数
+    size_t m_capacity; // 已分配的点数
+};
+
+} // namespace mviz 
\ No newline at end of file
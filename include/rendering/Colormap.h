@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mviz {
+
+// 点云按标量着色使用的色表
+enum class Colormap {
+    TURBO,    // 彩虹色，适合强度、高度等连续值
+    VIRIDIS,  // 感知均匀、亮度单调的连续色表
+    LABELS    // 离散调色板：按整数值取色（对色表大小取模），相邻编号颜色差异大，适合语义标签和线束编号
+};
+
+// 色表数量
+constexpr size_t COLORMAP_COUNT = 3;
+
+// 每个色表的颜色数
+constexpr size_t COLORMAP_SIZE = 256;
+
+// 色表是否按整数值取色（不按范围归一化，不插值）
+inline bool isDiscreteColormap(Colormap colormap) {
+    return colormap == Colormap::LABELS;
+}
+
+// 生成色表，rgba至少包含4 * COLORMAP_SIZE个元素（每个颜色依次为r、g、b、a，a固定为255）
+void buildColormap(Colormap colormap, uint8_t* rgba);
+
+} // namespace mviz 
\ No newline at end of file
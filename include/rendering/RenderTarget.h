@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace mviz {
+
+// 离屏渲染目标
+// 帧缓冲区带有RGBA8颜色和DEPTH24_STENCIL8深度模板两个渲染缓冲区，内容可以跨帧保留，并整体复制到默认帧缓冲区。
+// 深度模板格式与GLFW默认帧缓冲区一致，否则glBlitFramebuffer无法复制深度。
+class RenderTarget {
+public:
+    RenderTarget();
+    ~RenderTarget();
+    
+    RenderTarget(const RenderTarget&) = delete;
+    RenderTarget& operator=(const RenderTarget&) = delete;
+    
+    // 确保尺寸为width x height，尺寸改变时重新创建（之前的内容丢失）；返回帧缓冲区是否可用
+    bool resize(int width, int height);
+    
+    // 绑定为当前的绘制目标
+    void bind();
+    
+    // 把颜色和深度复制到默认帧缓冲区中以(x, y)为左下角的区域，之后绑定默认帧缓冲区
+    void blitToDefault(int x, int y);
+    
+    // 尺寸
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    
+private:
+    // 释放帧缓冲区和渲染缓冲区
+    void release();
+    
+    GLuint m_framebuffer;
+    GLuint m_colorBuffer;
+    GLuint m_depthBuffer;
+    int m_width;
+    int m_height;
+    bool m_complete;
+};
+
+} // namespace mviz 
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -10,6 +11,7 @@
 #include "core/Camera.h"
 #include "core/TFManager.h"
 #include "core/SceneManager.h"
+#include "rendering/Colormap.h"
 #include "rendering/Shader.h"
 #include "rendering/TextRenderer.h"
 
@@ -33,7 +35,8 @@ public:
     // 设置着色器和相机
     void setShader(const std::shared_ptr<Shader>& shader);
     void setCamera(const Camera* camera) { m_camera = camera; }
-    void setTFManager(const TFManager* tfManager) { m_tfManager = tfManager; }
+    // 设置本帧使用的TF快照，由场景管理器在每帧更新时设置
+    void setTFSnapshot(const TFSnapshot* tfSnapshot) { m_tfSnapshot = tfSnapshot; }
     void setSceneManager(const SceneManager* sceneManager) { m_sceneManager = sceneManager; }
     
     // 添加特定类型的着色器
@@ -45,6 +48,10 @@ public:
     // 获取当前活动着色器
     std::shared_ptr<Shader> getActiveShader() const { return m_shader; }
     
+    // 获取色表对应的1D纹理（RGBA8，COLORMAP_SIZE个颜色），首次使用时创建
+    // 连续色表使用线性插值，离散色表使用最近邻
+    GLuint getColormapTexture(Colormap colormap);
+    
     // 创建和绘制基础场景元素
     void createCoordinateAxes(float size = 1.0f);
     void drawCoordinateAxes();
@@ -79,12 +86,15 @@ private:
     std::shared_ptr<Shader> m_shader;
     std::unordered_map<ShaderType, std::shared_ptr<Shader>> m_shaders;
     const Camera* m_camera;
-    const TFManager* m_tfManager;
+    const TFSnapshot* m_tfSnapshot;
     const SceneManager* m_sceneManager;
     
     // 文本渲染器
     std::shared_ptr<TextRenderer> m_textRenderer;
     
+    // 色表纹理，按Colormap的值索引，0表示尚未创建
+    std::array<GLuint, COLORMAP_COUNT> m_colormapTextures;
+    
     // 坐标轴VAO, VBO
     unsigned int m_axesVAO, m_axesVBO;
     int m_axesVertexCount;
@@ -102,6 +112,7 @@ private:
         unsigned int vao;
         unsigned int vbo;
         int vertexCount;
+        FrameId id;
         std::string name;
         glm::vec3 position;
     };
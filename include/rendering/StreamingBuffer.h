@@ -0,0 +1,69 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+
+namespace mviz {
+
+// 流式顶点缓冲区
+// 把一个缓冲区分为REGION_COUNT段轮流写入：CPU写第N段时，GPU可以继续读取前几帧写入的其他段。
+// 支持GL_ARB_buffer_storage时使用持久映射，CPU直接写入GPU可见的内存，每段用栅栏保护；
+// 否则每次写入时映射对应段（不同步），该段仍被GPU使用时废弃整个缓冲区的旧存储（orphaning）而不等待。
+class StreamingBuffer {
+public:
+    // 缓冲区分段数（三重缓冲）
+    static constexpr size_t REGION_COUNT = 3;
+    
+    StreamingBuffer();
+    ~StreamingBuffer();
+    
+    StreamingBuffer(const StreamingBuffer&) = delete;
+    StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+    
+    // 开始写入下一段：返回至少size字节的可写内存，offset为该段在缓冲区中的字节偏移
+    // 调用后GL_ARRAY_BUFFER绑定到本缓冲区；失败时返回nullptr
+    void* beginWrite(size_t size, size_t& offset);
+    
+    // 结束写入；返回false表示写入的数据已丢失（映射期间存储被系统回收），需要重新写入
+    bool endWrite();
+    
+    // 在读取当前段的绘制命令之后调用，插入栅栏，防止该段在GPU读取完成前被再次写入
+    void fence();
+    
+    // OpenGL缓冲区对象
+    GLuint getBuffer() const { return m_buffer; }
+    
+    // 是否使用持久映射
+    bool isPersistent() const { return m_persistent; }
+    
+private:
+    // 按新的分段容量重新创建存储
+    void allocate(size_t regionCapacity);
+    
+    // 等待并删除指定段的栅栏
+    void waitRegion(size_t region);
+    
+    // 删除所有栅栏（不等待）
+    void clearFences();
+    
+    // 释放缓冲区
+    void release();
+    
+    GLuint m_buffer;
+    bool m_persistent;
+    
+    // 持久映射的起始地址（仅持久映射时有效）
+    unsigned char* m_mapped;
+    
+    // 每段的容量（字节）
+    size_t m_regionCapacity;
+    
+    // 当前写入的段
+    size_t m_region;
+    
+    // 每段最后一次被绘制命令使用后插入的栅栏
+    std::array<GLsync, REGION_COUNT> m_fences;
+};
+
+} // namespace mviz 
\ No newline at end of file
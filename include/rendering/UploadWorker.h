@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// 前向声明
+struct GLFWwindow; // 避免直接包含GLFW头文件
+
+namespace mviz {
+
+class UploadWorker;
+
+// 后台上传任务的完成状态
+class UploadTicket {
+public:
+    // GPU是否已执行完任务提交的所有命令；只能在渲染线程中调用
+    // 返回true之后任务创建的缓冲区等对象可以在渲染线程中使用
+    bool isComplete();
+    
+private:
+    friend class UploadWorker;
+    
+    std::atomic<bool> m_submitted{false}; // 任务已执行且栅栏已插入
+    GLsync m_fence = nullptr;             // 任务之后插入的栅栏
+    bool m_complete = false;
+};
+
+// 上传线程
+// 持有一个与主窗口共享对象的隐藏上下文，在后台线程中按提交顺序执行任务（如打包并上传点云），
+// 每个任务之后插入栅栏。缓冲区和栅栏在共享上下文之间通用，但VAO不共享，需要在渲染线程中创建和设置。
+class UploadWorker {
+public:
+    // 为主窗口创建上传线程，只能在主线程中调用；创建共享上下文失败时返回nullptr
+    static std::shared_ptr<UploadWorker> create(GLFWwindow* mainWindow);
+    
+    // 执行完已提交的任务后退出线程，只能在主线程中调用
+    ~UploadWorker();
+    
+    UploadWorker(const UploadWorker&) = delete;
+    UploadWorker& operator=(const UploadWorker&) = delete;
+    
+    // 提交任务，任务在上传线程的共享上下文中执行
+    std::shared_ptr<UploadTicket> submit(std::function<void()> task);
+    
+    // 放弃一个已提交的任务：在其之后执行cleanup（如删除任务创建的缓冲区）并删除其栅栏
+    // 调用后不能再使用ticket
+    void discard(std::shared_ptr<UploadTicket> ticket, std::function<void()> cleanup);
+    
+private:
+    struct Task {
+        std::function<void()> function;
+        std::shared_ptr<UploadTicket> ticket; // 为空时不插入栅栏
+    };
+    
+    explicit UploadWorker(GLFWwindow* context);
+    
+    // 线程主循环
+    void run();
+    
+    // 加入任务队列
+    void enqueue(Task task);
+    
+    GLFWwindow* m_context; // 隐藏窗口，只用于提供共享上下文
+    
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Task> m_tasks;
+    bool m_stopping;
+    
+    std::thread m_thread;
+};
+
+} // namespace mviz 
\ No newline at end of file
@@ -8,6 +8,7 @@
 struct GLFWwindow;
 namespace mviz {
     class SceneManager;
+    class PointCloudVisual;
 }
 
 namespace mviz {
@@ -45,9 +46,18 @@ private:
     // 渲染坐标系统设置
     void renderCoordinateSystemSettings(SceneManager& sceneManager);
 
+    // 渲染全局点数预算设置
+    void renderPointBudgetSettings(SceneManager& sceneManager);
+
     // 渲染可视化对象列表
     void renderVisualObjectList(SceneManager& sceneManager);
 
+    // 渲染点云的着色设置（颜色来源、色表和标量范围）
+    void renderPointCloudColorSettings(const std::string& name, PointCloudVisual& pointCloud);
+
+    // 渲染点云的过滤设置（裁剪框、距离带、标量阈值和裁剪平面）
+    void renderPointCloudFilterSettings(const std::string& name, PointCloudVisual& pointCloud);
+
     // 状态变量
     bool m_initialized;
     std::string m_selectedReferenceFrame;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/Frustum.h"
+#include "data/OctreeFile.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace mviz {
+
+class Camera;
+
+// 八叉树点云的LOD选择
+// 从根节点开始按屏幕空间误差（节点采样间距投影到屏幕上的像素数）从大到小遍历与视锥体相交的节点，
+// 误差小于阈值的节点不再细化，选中节点的总点数达到预算时停止。未加载的节点不继续向下遍历。
+
+// 视点参数（点云坐标系）
+struct OctreeView {
+    Frustum frustum;
+    glm::vec3 eye{0.0f};
+    float projectionScale = 1.0f;  // 距离为1处的单位长度在屏幕上的像素数：视口高度 / (2 * tan(fov / 2))
+    
+    // 由相机、点云的模型矩阵和视口高度（像素）求视点参数
+    static OctreeView fromCamera(const Camera& camera, const glm::mat4& model, int viewportHeight);
+};
+
+// 选择参数
+struct OctreeLODOptions {
+    float maxScreenError = 1.5f;   // 节点采样间距投影后超过该像素数时继续细化
+    size_t pointBudget = 10000000; // 选中节点（含未加载的）的最大总点数
+};
+
+// 选择结果
+struct OctreeSelection {
+    std::vector<uint32_t> visible;  // 已加载的选中节点，按优先级从高到低
+    std::vector<uint32_t> missing;  // 未加载的选中节点，按优先级从高到低
+    size_t visiblePoints = 0;       // visible中节点的总点数
+    
+    void clear() {
+        visible.clear();
+        missing.clear();
+        visiblePoints = 0;
+    }
+};
+
+// 节点在当前视点下的屏幕空间误差（像素），视点在节点包围球内时返回无穷大
+float octreeScreenError(const OctreeFile& file, uint32_t node, const OctreeView& view);
+
+// 选择本帧需要的节点，isLoaded判断节点的数据是否已在GPU上
+void selectOctreeNodes(const OctreeFile& file, const OctreeView& view, const OctreeLODOptions& options,
+                       const std::function<bool(uint32_t)>& isLoaded, OctreeSelection& selection);
+
+} // namespace mviz 
\ No newline at end of file
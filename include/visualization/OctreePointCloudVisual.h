@@ -0,0 +1,207 @@
+#pragma once
+
+#include "core/SceneManager.h"
+#include "visualization/OctreeLOD.h"
+#include <glad/glad.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mviz {
+
+class Camera;
+class OctreeFile;
+class UploadTicket;
+class UploadWorker;
+
+/**
+ * 八叉树LOD点云可视化对象
+ * 显示mviz_octree_convert生成的八叉树文件，点数可以远超内存和显存：文件被映射到内存，
+ * 每帧根据相机选择需要的节点，只把选中的节点上传到GPU；节点缓存超过显存上限时淘汰最久未使用的节点。
+ * 设置了上传线程时节点数据在上传线程中从映射的文件读出并上传，磁盘IO不阻塞渲染线程。
+ */
+class OctreePointCloudVisual : public VisualObject {
+public:
+    /**
+     * 构造函数
+     * @param name 对象名称
+     * @param frame_id 坐标系ID
+     */
+    OctreePointCloudVisual(const std::string& name, const std::string& frame_id);
+    
+    /**
+     * 析构函数
+     */
+    ~OctreePointCloudVisual() override;
+    
+    /**
+     * 打开八叉树文件，释放之前文件的所有节点
+     * @param path 文件路径
+     * @return 是否成功
+     */
+    bool open(const std::string& path);
+    
+    /**
+     * 设置用于LOD选择的相机
+     * @param camera 相机，为空时不选择也不绘制节点
+     */
+    void setCamera(std::shared_ptr<const Camera> camera) { m_camera = std::move(camera); }
+    
+    /**
+     * 设置加载节点的上传线程
+     * @param worker 上传线程，为空时在渲染线程中加载（每帧最多加载少量节点）
+     */
+    void setUploadWorker(std::shared_ptr<UploadWorker> worker) { m_uploadWorker = std::move(worker); }
+    
+    /**
+     * 设置LOD选择参数
+     * @param options 屏幕空间误差阈值和点数预算
+     */
+    void setLODOptions(const OctreeLODOptions& options) { m_lodOptions = options; }
+    
+    /**
+     * 获取LOD选择参数
+     * @return 选择参数
+     */
+    const OctreeLODOptions& getLODOptions() const { return m_lodOptions; }
+    
+    /**
+     * 设置节点缓存的显存上限
+     * @param bytes 字节数，默认512MB
+     */
+    void setGpuMemoryLimit(size_t bytes) { m_gpuMemoryLimit = bytes; }
+    
+    /**
+     * 获取节点缓存的显存上限
+     * @return 字节数
+     */
+    size_t getGpuMemoryLimit() const { return m_gpuMemoryLimit; }
+    
+    /**
+     * 设置点的大小
+     * @param size 点的大小
+     */
+    void setPointSize(float size) { m_pointSize = size > 0.0f ? size : m_pointSize; }
+    
+    /**
+     * 获取点的大小
+     * @return 点的大小
+     */
+    float getPointSize() const { return m_pointSize; }
+    
+    /**
+     * 设置统一颜色（文件没有颜色时使用）
+     * @param color RGB颜色
+     */
+    void setUniformColor(const glm::vec3& color) { m_uniformColor = color; }
+    
+    /**
+     * 获取统一颜色
+     * @return RGB颜色
+     */
+    const glm::vec3& getUniformColor() const { return m_uniformColor; }
+    
+    /**
+     * 获取上一次绘制的点数和节点数
+     * @return 点数
+     */
+    size_t getDrawnPointCount() const { return m_drawnPointCount; }
+    size_t getDrawnNodeCount() const { return m_selection.visible.size(); }
+    
+    /**
+     * 获取文件中的总点数
+     * @return 点数，未打开文件时为0
+     */
+    size_t getTotalPointCount() const;
+    
+    /**
+     * 获取节点缓存占用的显存（含正在加载的节点）
+     * @return 字节数
+     */
+    size_t getCachedBytes() const { return m_cachedBytes; }
+    
+    /**
+     * 获取根节点立方体作为包围盒
+     * @param min 最小角点
+     * @param max 最大角点
+     * @return 是否已打开文件
+     */
+    bool getLocalBounds(glm::vec3& min, glm::vec3& max) const override;
+    
+    /**
+     * 选择本帧的节点，完成已结束的加载并发起新的加载（在模型矩阵更新之后调用）
+     */
+    void updateResources() override;
+    
+    /**
+     * 绘制选中的节点
+     * @param renderer 渲染器
+     * @param view_projection_matrix 视图投影矩阵
+     */
+    void draw(Renderer& renderer, const glm::mat4& view_projection_matrix) override;
+    
+private:
+    // 上传线程中进行的节点加载，由上传线程填写buffer；worker为执行加载的上传线程
+    struct NodeLoad {
+        GLuint buffer = 0;
+        std::shared_ptr<UploadTicket> ticket;
+        std::shared_ptr<UploadWorker> worker;
+    };
+    
+    // 节点的GPU缓存状态
+    struct NodeCache {
+        enum class State {
+            UNLOADED,
+            LOADING,
+            LOADED
+        };
+        
+        State state = State::UNLOADED;
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        uint64_t lastUsedFrame = 0;           // 最近一次被选中的帧
+        glm::vec3 scale{1.0f};                // 位置解码参数
+        glm::vec3 offset{0.0f};
+        std::shared_ptr<NodeLoad> load;       // 正在进行的加载
+    };
+    
+    // 完成上传线程中已结束的加载
+    void finishLoads();
+    
+    // 按优先级为选中但未加载的节点发起加载
+    void requestLoads();
+    
+    // 创建节点的VAO并标记为已加载
+    void activateNode(uint32_t node, GLuint buffer);
+    
+    // 淘汰本帧未使用的节点，直到缓存不超过targetBytes
+    bool evictUntil(size_t targetBytes);
+    
+    // 释放一个节点的GPU资源
+    void releaseNode(uint32_t node);
+    
+    // 释放所有节点（正在加载的交给上传线程在加载完成后删除）
+    void releaseAllNodes();
+    
+    // 文件在上传线程的任务中同样被引用，任务结束前保持映射
+    std::shared_ptr<OctreeFile> m_file;
+    std::vector<NodeCache> m_nodes;
+    
+    std::shared_ptr<const Camera> m_camera;
+    std::shared_ptr<UploadWorker> m_uploadWorker;
+    
+    OctreeLODOptions m_lodOptions;
+    OctreeSelection m_selection;
+    
+    // 缓存
+    size_t m_gpuMemoryLimit;
+    size_t m_cachedBytes;
+    std::vector<uint32_t> m_loadingNodes;
+    uint64_t m_frame;
+    
+    float m_pointSize;
+    glm::vec3 m_uniformColor;
+    size_t m_drawnPointCount;
+};
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace mviz {
+
+// 点云分块
+// 上传前把点按空间位置重新排列，使每一块占用顶点缓冲区中连续的一段，绘制时只提交与视锥体相交的块。
+
+// 一块点：顶点缓冲区中[first, first + count)的点及其包围盒（点云坐标系）
+struct PointChunk {
+    uint32_t first = 0;
+    uint32_t count = 0;
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+};
+
+// 每块的最大点数
+constexpr size_t MAX_CHUNK_POINTS = 16384;
+
+// 把点划分为空间上紧凑的块
+// 包围盒[min, max]被均匀划分为32x32x32个单元，按单元的Morton序排列点（单元内保持原来的顺序），
+// 再把相邻的单元合并为不超过maxChunkPoints个点的块，单元本身超过上限时拆分。
+// order[i]为排列后第i个点在原数组中的下标。块的包围盒不在这里计算，由调用方在按order重排点时顺便求出。
+void buildPointChunks(const glm::vec3* points, size_t count, const glm::vec3& min, const glm::vec3& max,
+                      size_t maxChunkPoints, std::vector<uint32_t>& order, std::vector<PointChunk>& chunks);
+
+// 把每块内的点打乱为确定的伪随机顺序（同样的输入总是得到同样的结果）
+// 之后任一块的前k个点都是该块的无偏随机子样本，按相同比例绘制各块的前缀即可均匀地降采样整个点云。
+void shuffleWithinChunks(std::vector<uint32_t>& order, const std::vector<PointChunk>& chunks);
+
+} // namespace mviz 
\ No newline at end of file
@@ -2,16 +2,92 @@
 
 #include "core/SceneManager.h"
 #include "data/DataTypes.h"
+#include "rendering/Colormap.h"
+#include "visualization/PointChunks.h"
 #include <glad/glad.h>
+#include <chrono>
 #include <memory>
 
 namespace mviz {
 
+class Shader;
+class StreamingBuffer;
+class UploadTicket;
+class UploadWorker;
+
 /**
  * 点云可视化对象类
  */
 class PointCloudVisual : public VisualObject {
 public:
+    /**
+     * GPU缓冲区更新方式
+     */
+    enum class UpdateMode {
+        STATIC,    // 每次更新重新分配存储，适合很少变化的点云
+        STREAMING, // 三重缓冲的流式上传，适合每帧都更新的点云
+        ASYNC      // 在上传线程中打包和上传，完成前继续绘制之前的数据；未设置上传线程时按STATIC处理
+    };
+    
+    /**
+     * GPU端位置格式
+     */
+    enum class PositionEncoding {
+        FLOAT32,  // float3，12字节
+        INT16     // 相对于点云包围盒量化的int16（含填充），8字节
+    };
+    
+    /**
+     * GPU端颜色格式
+     */
+    enum class ColorEncoding {
+        RGBA8,    // 归一化的RGBA8，4字节；点云没有颜色数据时同样使用统一颜色
+        UNIFORM   // 不上传颜色，所有点使用统一颜色
+    };
+    
+    /**
+     * 点的颜色来源
+     * 下列标量属性在上传时全部写入GPU（统一转换为uint16），切换来源、色表或范围只改变顶点属性绑定和着色器参数，
+     * 不需要重新上传
+     */
+    enum class ColorSource {
+        RGB,        // 点云的RGB颜色（没有上传颜色时使用统一颜色）
+        HEIGHT,     // 参考坐标系中沿高度轴的坐标
+        INTENSITY,  // 强度属性（ATTRIBUTE_INTENSITY）
+        RING,       // 线束编号属性（ATTRIBUTE_RING）
+        LABEL       // 语义标签属性（ATTRIBUTE_LABEL）
+    };
+    
+    /**
+     * GPU端点过滤条件
+     * 几何条件都在点云自身坐标系（传感器坐标系）中定义，在顶点着色器中剔除不满足条件的点，
+     * 修改不需要重新上传；包围盒完全不满足条件的块和累积帧在CPU端直接跳过
+     */
+    struct PointFilter {
+        // 有向裁剪框：只保留框内的点，旋转为依次绕X、Y、Z轴的欧拉角（度）
+        bool cropEnabled = false;
+        glm::vec3 cropCenter{0.0f};
+        glm::vec3 cropHalfSize{1.0f};
+        glm::vec3 cropRotation{0.0f};
+        
+        // 距离带：只保留到坐标原点（传感器）的距离在[minRange, maxRange]内的点
+        bool rangeEnabled = false;
+        float minRange = 0.0f;
+        float maxRange = 100.0f;
+        
+        // 标量阈值：只保留属性值在[scalarMin, scalarMax]内的点，scalarSource为INTENSITY、RING或LABEL，
+        // 数据中没有该属性时不过滤
+        bool scalarEnabled = false;
+        ColorSource scalarSource = ColorSource::INTENSITY;
+        float scalarMin = 0.0f;
+        float scalarMax = 1.0f;
+        
+        // 裁剪平面：只保留满足 dot(planeNormal, p) + planeOffset >= 0 的点
+        bool planeEnabled = false;
+        glm::vec3 planeNormal{0.0f, 1.0f, 0.0f};
+        float planeOffset = 0.0f;
+    };
+    
     /**
      * 构造函数
      * @param name 对象名称
@@ -25,16 +101,42 @@ public:
     ~PointCloudVisual() override;
     
     /**
-     * 更新点云数据
+     * 更新点云数据（复制一份）
      * @param pointCloud 点云数据
      */
     void setPointCloud(const PointCloudData& pointCloud);
     
+    /**
+     * 更新点云数据（移入，不复制）
+     * @param pointCloud 点云数据
+     */
+    void setPointCloud(PointCloudData&& pointCloud);
+    
+    /**
+     * 更新点云数据（共享，不复制）
+     * 同一帧点云可以同时交给多个可视化对象或历史记录，数据在设置后不应再被修改
+     * @param pointCloud 点云数据
+     */
+    void setPointCloud(std::shared_ptr<const PointCloudData> pointCloud);
+    
     /**
      * 获取点云数据
-     * @return 点云数据的常引用
+     * 上传到GPU后CPU端数据即被释放（除非设置了保留），此时返回nullptr
+     * @return 点云数据
+     */
+    std::shared_ptr<const PointCloudData> getPointCloud() const { return m_pointCloud; }
+    
+    /**
+     * 设置上传到GPU后是否保留CPU端的点云数据
+     * @param retain 是否保留，默认不保留
      */
-    const PointCloudData& getPointCloud() const { return m_pointCloudData; }
+    void setRetainCpuData(bool retain) { m_retainCpuData = retain; }
+    
+    /**
+     * 上传到GPU后是否保留CPU端的点云数据
+     * @return 是否保留
+     */
+    bool getRetainCpuData() const { return m_retainCpuData; }
     
     /**
      * 设置点的大小
@@ -46,14 +148,266 @@ public:
      * 获取点的大小
      * @return 点的大小
      */
-    float getPointSize() const { return m_pointCloudData.pointSize; }
+    float getPointSize() const { return m_pointSize; }
+    
+    /**
+     * 设置GPU缓冲区更新方式，默认为STATIC
+     * @param mode 更新方式
+     */
+    void setUpdateMode(UpdateMode mode) { m_updateMode = mode; }
+    
+    /**
+     * 获取GPU缓冲区更新方式
+     * @return 更新方式
+     */
+    UpdateMode getUpdateMode() const { return m_updateMode; }
+    
+    /**
+     * 设置ASYNC模式使用的上传线程
+     * @param worker 上传线程，为空时ASYNC模式按STATIC处理
+     */
+    void setUploadWorker(std::shared_ptr<UploadWorker> worker) { m_uploadWorker = std::move(worker); }
+    
+    /**
+     * 更新从first开始的一段连续点的位置，点数不变
+     * 多次修改在下一次updateResources()时合并，只上传修改过的字节范围；设置新的点云会丢弃尚未上传的修改。
+     * 仅适用于STATIC和ASYNC模式（不含累积模式）。位置量化为int16时，超出原包围盒的坐标会被截断。
+     * 保留的CPU端点云数据是共享且不可变的，不会随之修改。
+     * @param first 第一个点的下标
+     * @param positions 新的位置
+     * @return 范围超出点数或当前模式不支持时返回false
+     */
+    bool updatePositions(size_t first, const std::vector<glm::vec3>& positions);
+    
+    /**
+     * 更新从first开始的一段连续点的颜色，规则与updatePositions()相同
+     * 点云上传时没有颜色属性（UNIFORM模式或没有颜色数据）时修改被忽略
+     * @param first 第一个点的下标
+     * @param colors 新的RGB颜色
+     * @return 范围超出点数或当前模式不支持时返回false
+     */
+    bool updateColors(size_t first, const std::vector<glm::vec3>& colors);
+    
+    /**
+     * 设置多帧累积显示
+     * GPU缓冲区被分为maxScans个槽位，每次新的点云只写入最旧的槽位，所有未过期的槽位一起绘制；
+     * 每帧点云使用写入时的模型矩阵，参考坐标系为固定坐标系时旧的扫描保持在原位。累积模式下忽略UpdateMode。
+     * @param maxScans 最多同时显示的帧数，0表示关闭累积（默认）
+     * @param decayTime 每帧点云的显示时长（秒），在此期间逐渐淡出，0表示不按时间淡出
+     */
+    void setAccumulation(size_t maxScans, float decayTime);
+    
+    /**
+     * 获取累积显示的最大帧数
+     * @return 最大帧数，0表示未开启累积
+     */
+    size_t getAccumulationScans() const { return m_slots.size(); }
+    
+    /**
+     * 获取累积显示中每帧点云的显示时长
+     * @return 显示时长（秒）
+     */
+    float getDecayTime() const { return m_decayTime; }
+    
+    /**
+     * 设置GPU端位置格式，默认为FLOAT32
+     * 对下一次上传生效；保留了CPU端数据时立即重新上传
+     * @param encoding 位置格式
+     */
+    void setPositionEncoding(PositionEncoding encoding);
+    
+    /**
+     * 获取GPU端位置格式
+     * @return 位置格式
+     */
+    PositionEncoding getPositionEncoding() const { return m_positionEncoding; }
+    
+    /**
+     * 设置GPU端颜色格式，默认为RGBA8
+     * 对下一次上传生效；保留了CPU端数据时立即重新上传
+     * @param encoding 颜色格式
+     */
+    void setColorEncoding(ColorEncoding encoding);
+    
+    /**
+     * 获取GPU端颜色格式
+     * @return 颜色格式
+     */
+    ColorEncoding getColorEncoding() const { return m_colorEncoding; }
+    
+    /**
+     * 设置统一颜色（UNIFORM模式或点云没有颜色数据时使用）
+     * @param color RGB颜色
+     */
+    void setUniformColor(const glm::vec3& color);
+    
+    /**
+     * 获取统一颜色
+     * @return RGB颜色
+     */
+    const glm::vec3& getUniformColor() const { return m_uniformColor; }
+    
+    /**
+     * 设置颜色来源，默认为RGB；当前数据没有所选的标量属性时按RGB着色
+     * @param source 颜色来源
+     */
+    void setColorSource(ColorSource source);
+    
+    /**
+     * 获取颜色来源
+     * @return 颜色来源
+     */
+    ColorSource getColorSource() const { return m_colorSource; }
+    
+    /**
+     * 最近设置的点云是否包含某种颜色来源所需的属性，该属性随点云一起上传（RGB和HEIGHT总是可用）
+     * @param source 颜色来源
+     * @return 是否可用
+     */
+    bool hasColorSource(ColorSource source) const;
+    
+    /**
+     * 设置按标量着色时使用的色表，默认为TURBO；离散色表按整数值取色，忽略范围
+     * @param colormap 色表
+     */
+    void setColormap(Colormap colormap);
+    
+    /**
+     * 获取按标量着色时使用的色表
+     * @return 色表
+     */
+    Colormap getColormap() const { return m_colormap; }
+    
+    /**
+     * 设置标量映射到色表两端的范围，同时关闭自动范围
+     * @param min 映射到色表起点的值
+     * @param max 映射到色表终点的值
+     */
+    void setScalarRange(float min, float max);
+    
+    /**
+     * 获取上一次绘制使用的标量范围（自动范围时为计算出的范围）
+     * @param min 映射到色表起点的值
+     * @param max 映射到色表终点的值
+     */
+    void getScalarRange(float& min, float& max) const;
+    
+    /**
+     * 设置是否按数据自动确定标量范围（默认开启）：属性为上传时统计的最小值和最大值，高度为包围盒在高度轴上的投影
+     * @param autoRange 是否自动
+     */
+    void setAutoScalarRange(bool autoRange);
+    
+    /**
+     * 是否按数据自动确定标量范围
+     * @return 是否自动
+     */
+    bool getAutoScalarRange() const { return m_autoScalarRange; }
     
     /**
-     * 更新对象变换矩阵
-     * @param tf_manager TF管理器
-     * @param reference_frame 参考坐标系
+     * 设置按高度着色时使用的参考坐标系中的高度方向，默认为+Y
+     * @param axis 高度方向（会被归一化）
      */
-    void update(TFManager& tf_manager, const std::string& reference_frame) override;
+    void setHeightAxis(const glm::vec3& axis);
+    
+    /**
+     * 获取高度方向
+     * @return 单位向量
+     */
+    const glm::vec3& getHeightAxis() const { return m_heightAxis; }
+    
+    /**
+     * 设置点过滤条件，下一次绘制生效；被过滤的点仍计入绘制的点数和点数预算
+     * @param filter 过滤条件
+     */
+    void setFilter(const PointFilter& filter);
+    
+    /**
+     * 获取点过滤条件
+     * @return 过滤条件
+     */
+    const PointFilter& getFilter() const { return m_filter; }
+    
+    /**
+     * 设置是否按视锥体剔除点云块，默认开启
+     * 开启时STATIC和ASYNC模式在上传时把点按空间位置重排并分块，只绘制与视锥体相交的块；
+     * 重排后每个点需要额外4字节的CPU端下标映射，以便局部修改找到点在缓冲区中的位置。对下一次上传生效。
+     * @param enabled 是否开启
+     */
+    void setFrustumCulling(bool enabled) { m_frustumCulling = enabled; }
+    
+    /**
+     * 是否按视锥体剔除点云块
+     * @return 是否开启
+     */
+    bool getFrustumCulling() const { return m_frustumCulling; }
+    
+    /**
+     * 获取上一次绘制提交的点数（剔除之后）
+     * @return 点数
+     */
+    size_t getDrawnPointCount() const { return m_drawnPointCount; }
+    
+    /**
+     * 获取当前缓冲区中的点数
+     * @return 点数
+     */
+    size_t getPointCount() const { return m_pointCount; }
+    
+    /**
+     * 设置每次绘制最多提交的点数，超出时均匀降采样，由SceneManager按全局预算每帧分配
+     * 分块的点云每块内的点在上传时被打乱，按相同比例绘制各可见块的前缀；
+     * 未分块的数据（流式、累积或关闭剔除）按固定间隔取点，间隔受顶点属性步长限制，达到上限后再均匀分段绘制。
+     * @param budget 点数，0表示不限制（默认）
+     */
+    void setPointBudget(size_t budget) { m_pointBudget = budget; }
+    
+    /**
+     * 获取每次绘制最多提交的点数
+     * @return 点数，0表示不限制
+     */
+    size_t getPointBudget() const { return m_pointBudget; }
+    
+    /**
+     * 获取不限制点数时一次绘制最多提交的点数（累积模式下为未过期的各帧点数之和），用于分配预算
+     * @return 点数
+     */
+    size_t getDrawablePointCount() const;
+    
+    /**
+     * 是否支持按比例分段绘制（见setDrawSlice），只有分块上传且未开启累积的点云支持
+     * @return 是否支持
+     */
+    bool supportsDrawSlices() const { return m_slots.empty() && !m_chunkIndex.chunks.empty(); }
+    
+    /**
+     * 设置之后的绘制只提交每个可见块中[begin, end)比例范围内的点，忽略点数预算
+     * 块内的点已被打乱，依次绘制[0, 1/N)、[1/N, 2/N)……N段即可把整个点云分N帧逐步画完，每段都均匀分布。
+     * 恢复为[0, 1)即取消分段；不支持分段的点云忽略此设置。
+     * @param begin 起始比例
+     * @param end 结束比例
+     */
+    void setDrawSlice(double begin, double end);
+    
+    /**
+     * 获取绘制结果的版本号，GPU数据、点的大小或颜色等影响绘制结果的状态改变时增加
+     * 用于判断缓存的绘制结果（如渐进绘制的离屏图像）是否仍然有效
+     * @return 版本号
+     */
+    uint64_t getRevision() const { return m_revision; }
+    
+    /**
+     * 获取点云在自身坐标系中的包围盒（累积模式下各帧使用不同的模型矩阵，返回false）
+     * @param min 最小角点
+     * @param max 最大角点
+     * @return 是否有有效的包围盒
+     */
+    bool getLocalBounds(glm::vec3& min, glm::vec3& max) const override;
+    
+    /**
+     * 更新GPU缓冲区（在模型矩阵更新之后调用）
+     */
+    void updateResources() override;
     
     /**
      * 绘制点云
@@ -63,12 +417,165 @@ public:
     void draw(Renderer& renderer, const glm::mat4& view_projection_matrix) override;
     
 private:
-    // 点云数据
-    PointCloudData m_pointCloudData;
+    // 一个上传的属性块：每个点一个uint16，解码为 value = stored * scale + bias
+    // 取值能用uint16表示的整数属性按原值上传，其他属性按取值范围量化
+    struct AttributeBlock {
+        std::string name;       // 属性通道名称
+        size_t offset = 0;      // 相对于顶点数据起始的字节偏移
+        float scale = 1.0f;
+        float bias = 0.0f;
+        float min = 0.0f;       // 解码后的取值范围
+        float max = 0.0f;
+    };
+    
+    // GPU端顶点布局描述：[所有点的位置][所有点的颜色][需要的各属性通道]
+    struct VertexLayout {
+        size_t count = 0;           // 点数
+        bool quantized = false;     // 位置是否量化为int16
+        bool hasColors = false;     // 是否包含颜色属性
+        size_t positionStride = 0;  // 每个位置占用的字节数
+        size_t positionBytes = 0;   // 位置块的字节数
+        size_t colorBytes = 0;      // 颜色块的字节数
+        size_t attributeBytes = 0;  // 所有属性块的字节数（每块按4字节对齐）
+        std::vector<AttributeBlock> attributes;
+        glm::vec3 scale{1.0f};      // 位置解码缩放
+        glm::vec3 offset{0.0f};     // 位置解码偏移
+        glm::vec3 min{0.0f};        // 点的包围盒（点云坐标系）
+        glm::vec3 max{0.0f};
+        
+        size_t totalBytes() const { return positionBytes + colorBytes + attributeBytes; }
+        
+        // 按名称查找属性块，返回下标，没有上传该属性时返回-1
+        int findAttribute(const char* name) const;
+    };
+    
+    // 分块后的点序：各块在缓冲区中的范围和包围盒，以及每个原始下标在缓冲区中的位置；未分块时为空
+    struct ChunkIndex {
+        std::vector<PointChunk> chunks;
+        std::vector<uint32_t> packedIndex;
+    };
+    
+    // 后台上传任务，由上传线程填写buffer、succeeded和chunkIndex
+    // worker为执行该任务的上传线程，更换或清除上传线程后仍通过它放弃任务
+    struct AsyncUpload {
+        std::shared_ptr<const PointCloudData> pointCloud;
+        VertexLayout layout;
+        bool chunked = false;
+        ChunkIndex chunkIndex;
+        GLuint buffer = 0;
+        bool succeeded = false;
+        std::shared_ptr<UploadTicket> ticket;
+        std::shared_ptr<UploadWorker> worker;
+    };
+    
+    // 顶点数组对象当前的设置：取点间隔、绑定到属性2（着色）和属性3（过滤）的标量通道（-1表示不绑定）
+    struct VaoBinding {
+        size_t step = 1;
+        int channel = -1;
+        int filterChannel = -1;
+        
+        bool operator==(const VaoBinding& other) const {
+            return step == other.step && channel == other.channel && filterChannel == other.filterChannel;
+        }
+    };
+    
+    // 累积模式中的一个扫描槽位
+    struct ScanSlot {
+        GLuint vao = 0;          // 指向该槽位数据的顶点数组对象
+        VertexLayout layout;     // 槽位中数据的布局，count为0表示空槽位
+        glm::mat4 model{1.0f};   // 写入时的模型矩阵
+        double time = 0.0;       // 写入时间（秒，相对于m_timeOrigin）
+        size_t base = 0;         // 数据在累积缓冲区中的字节偏移
+        VaoBinding binding;      // vao当前的设置
+    };
+    
+    // 等待上传的点云数据（与调用方共享，不修改）
+    std::shared_ptr<const PointCloudData> m_pointCloud;
+    
+    // 点的大小
+    float m_pointSize;
+    
+    // 上传后是否保留CPU端数据
+    bool m_retainCpuData;
+    
+    // GPU缓冲区更新方式
+    UpdateMode m_updateMode;
+    
+    // GPU端顶点格式
+    PositionEncoding m_positionEncoding;
+    ColorEncoding m_colorEncoding;
+    glm::vec3 m_uniformColor;
+    
+    // 按标量着色：颜色来源、色表、手动范围、上一次绘制使用的范围和高度方向
+    ColorSource m_colorSource;
+    Colormap m_colormap;
+    bool m_autoScalarRange;
+    float m_scalarMin;
+    float m_scalarMax;
+    float m_drawnScalarMin;
+    float m_drawnScalarMax;
+    glm::vec3 m_heightAxis;
+    
+    // 点过滤条件，以及由其求出的裁剪框逆旋转和裁剪框在点云坐标系中的包围盒
+    PointFilter m_filter;
+    glm::mat3 m_cropInverseRotation;
+    glm::vec3 m_cropMin;
+    glm::vec3 m_cropMax;
+    
+    // 当前绘制的缓冲区（m_vao所指向的数据）的布局和解码参数
+    VertexLayout m_layout;
+    
+    // 最近设置的点云中会上传的标量属性通道名称
+    std::vector<std::string> m_attributeNames;
+    
+    // 视锥体剔除：是否对新上传的点云分块、当前缓冲区的分块和上一次绘制的点数
+    bool m_frustumCulling;
+    ChunkIndex m_chunkIndex;
+    size_t m_drawnPointCount;
+    
+    // 每次绘制最多提交的点数，0表示不限制
+    size_t m_pointBudget;
+    
+    // 分段绘制的比例范围，[0, 1)表示不分段
+    double m_sliceBegin;
+    double m_sliceEnd;
+    
+    // 绘制结果的版本号
+    uint64_t m_revision;
+    
+    // 按块或分段按间隔绘制时每段的起点和点数，跨帧复用
+    std::vector<GLint> m_drawFirsts;
+    std::vector<GLsizei> m_drawCounts;
+    
+    // 尚未上传的局部修改，每项为从first开始的一段连续点
+    struct RangeEdit {
+        size_t first;
+        std::vector<glm::vec3> values;
+    };
+    std::vector<RangeEdit> m_positionEdits;
+    std::vector<RangeEdit> m_colorEdits;
     
     // OpenGL缓冲对象
     GLuint m_vao; // 顶点数组对象
-    GLuint m_vbo; // 顶点缓冲对象
+    GLuint m_vbo; // 顶点缓冲对象（STATIC模式）
+    
+    // m_vao当前使用的缓冲区、数据起始偏移和设置，降采样或切换标量属性时据此重新设置顶点属性
+    GLuint m_vaoBuffer;
+    size_t m_vaoBase;
+    VaoBinding m_vaoBinding;
+    std::unique_ptr<StreamingBuffer> m_streamingBuffer; // 流式顶点缓冲区（STREAMING模式，首次使用时创建）
+    
+    // 上传线程和正在进行的后台上传（ASYNC模式，同一时刻最多一个）
+    std::shared_ptr<UploadWorker> m_uploadWorker;
+    std::shared_ptr<AsyncUpload> m_pendingUpload;
+    
+    // 多帧累积：槽位、存放所有槽位数据的缓冲区、每个槽位的容量和下一个写入的槽位
+    std::vector<ScanSlot> m_slots;
+    GLuint m_accumulationBuffer;
+    size_t m_slotCapacity;
+    size_t m_nextSlot;
+    float m_decayTime;
+    std::chrono::steady_clock::time_point m_timeOrigin;
     
     // 是否需要更新缓冲区
     bool m_needBufferUpdate;
@@ -82,6 +589,112 @@ private:
     // 更新OpenGL缓冲区
     void updateBuffers();
     
+    // 按当前编码方式计算顶点布局（不含量化参数），包含点云中着色器能读取的所有标量属性通道
+    VertexLayout computeLayout(const PointCloudData& pointCloud) const;
+    
+    // 把点云转换为顶点数据写入dst，同时求出layout中的包围盒和解码参数；可在任意线程调用
+    // chunkIndex不为空时先把点按空间位置分块重排，再按重排后的顺序写入
+    static void writeVertices(const PointCloudData& pointCloud, VertexLayout& layout, uint8_t* dst,
+                              ChunkIndex* chunkIndex);
+    
+    // 统计各属性块的取值范围并求出解码参数
+    static void prepareAttributes(const PointCloudData& pointCloud, VertexLayout& layout);
+    
+    // 把点云中的属性写入dst中对应的块：第i个输出为缓冲区中第first + i个点，
+    // 取自原数组中下标为indices[i]的点（indices为空时为first + i）
+    static void writeAttributes(const PointCloudData& pointCloud, const VertexLayout& layout, uint8_t* dst,
+                                const uint32_t* indices, size_t first, size_t count);
+    
+    // 让vao使用buffer中从base开始的顶点数据，binding.step大于1时每隔step个点取一个点，
+    // binding.channel不为-1时把该标量属性绑定到属性2
+    static void bindLayout(GLuint vao, GLuint buffer, size_t base, const VertexLayout& layout,
+                           const VaoBinding& binding);
+    
+    // 设置与binding不同时重新设置vao
+    static void updateBinding(GLuint vao, GLuint buffer, size_t base, const VertexLayout& layout, VaoBinding& binding,
+                              const VaoBinding& target);
+    
+    // 让m_vao使用buffer中从base开始的顶点数据，并更新点数、解码参数和分块
+    void applyLayout(GLuint buffer, size_t base, const VertexLayout& layout, ChunkIndex chunkIndex);
+    
+    // 把当前点云写入累积缓冲区中最旧的槽位
+    void accumulateScan();
+    
+    // 确保每个槽位至少能容纳bytes字节，扩容时保留已有的扫描
+    void reserveSlots(size_t bytes);
+    
+    // 释放累积模式的所有资源
+    void releaseAccumulation();
+    
+    // 当前时间（秒，相对于m_timeOrigin）
+    double currentTime() const;
+    
+    // 把当前点云提交给上传线程
+    void submitAsyncUpload();
+    
+    // 后台上传完成后切换到新的缓冲区
+    void finishAsyncUpload();
+    
+    // 局部修改作用的点数：尚未上传的点云或正在后台上传的点云的点数，否则为当前缓冲区的点数
+    size_t editablePointCount() const;
+    
+    // 记录一次局部修改
+    bool addRangeEdit(std::vector<RangeEdit>& edits, size_t first, const std::vector<glm::vec3>& values);
+    
+    // 合并并上传所有局部修改
+    void flushRangeEdits();
+    
+    // 把修改按下标合并为互不重叠的连续范围，后提交的修改覆盖先提交的
+    static std::vector<RangeEdit> coalesceRangeEdits(const std::vector<RangeEdit>& edits);
+    
+    // 按当前缓冲区的格式打包并上传缓冲区中从first开始的一段位置或颜色
+    void uploadPositions(size_t first, const glm::vec3* positions, size_t count);
+    void uploadColors(size_t first, const glm::vec3* colors, size_t count);
+    
+    // 用修改后的位置扩大包围盒和所在块的包围盒，first为缓冲区中的位置
+    void growBounds(size_t first, const glm::vec3* positions, size_t count);
+    
+    // 绘制m_vao中与视锥体相交且可能通过过滤的块；不超出预算时相邻的块合并，超出时每块按相同比例只绘制前缀；
+    // 设置了分段时每块只绘制该段
+    void drawChunks(const glm::mat4& view_projection_matrix);
+    
+    // 按预算绘制未分块的顶点数据：超出预算时增大顶点属性的步长，按固定间隔取点；步长达到上限后仍超出预算时
+    // 把取出的点均分为若干段，每段绘制相同比例的前缀
+    // binding为vao当前的设置，target为需要的标量通道（其中的step被忽略），设置改变时重新设置vao；返回绘制的点数
+    size_t drawStrided(GLuint vao, GLuint buffer, size_t base, const VertexLayout& layout, VaoBinding& binding,
+                       VaoBinding target, size_t budget);
+    
+    // 颜色来源对应的属性通道名称，RGB和HEIGHT返回nullptr
+    static const char* sourceAttribute(ColorSource source);
+    
+    // 当前过滤条件需要的属性通道名称，未开启标量阈值时返回nullptr
+    const char* filterAttribute() const;
+    
+    // 按当前颜色来源需要绑定的属性块，数据中没有该属性或来源不是标量属性时返回-1
+    int scalarChannel(const VertexLayout& layout) const;
+    
+    // 按当前过滤条件需要绑定的属性块，未开启标量阈值或数据中没有该属性时返回-1
+    int filterChannel(const VertexLayout& layout) const;
+    
+    // 属性通道能否被着色器读取（作为颜色来源或过滤条件的单分量标量），只有这些通道会上传
+    static bool isShaderAttribute(const PointAttribute& attribute);
+    
+    // 绘制layout中的数据需要的顶点属性设置（取点间隔为1）
+    VaoBinding attributeBinding(const VertexLayout& layout) const;
+    
+    // 点云坐标系中的包围盒内是否可能有点通过过滤（保守判断）
+    bool filterMayPass(const glm::vec3& min, const glm::vec3& max) const;
+    
+    // 按数据求自动标量范围：标量属性为统计的范围，高度为模型矩阵变换后的包围盒在高度轴上的投影；
+    // 颜色来源不是标量时返回false
+    bool computeScalarRange(const VertexLayout& layout, const glm::mat4& model, float& min, float& max) const;
+    
+    // 设置颜色相关的着色器参数（颜色模式、标量解码参数、范围和色表纹理）
+    void setColorUniforms(Shader& shader, Renderer& renderer, const VertexLayout& layout, int channel) const;
+    
+    // 设置过滤相关的着色器参数，filterChannel为绑定到属性3的标量通道
+    void setFilterUniforms(Shader& shader, const VertexLayout& layout, int filterChannel) const;
+    
     // 清理OpenGL资源
     void cleanupGLResources();
 };
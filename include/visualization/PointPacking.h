@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace mviz {
+
+// 点云顶点打包工具
+// 把点云的浮点位置和颜色转换为紧凑的GPU顶点格式，x86_64上使用SSE（CPU支持时使用SSSE3）每次处理4个点，
+// 其他平台使用等价的标量实现。输入数组中的glm::vec3必须紧密排列（std::vector<glm::vec3>满足要求）。
+
+// int16量化位置的取值范围为[-QUANTIZED_MAX, QUANTIZED_MAX]
+constexpr float QUANTIZED_MAX = 32767.0f;
+
+// 计算点的包围盒，忽略NaN坐标；count为0或没有有效点时min和max保持不变
+void computePointBounds(const glm::vec3* points, size_t count, glm::vec3& min, glm::vec3& max);
+
+// 根据包围盒求量化参数：解码时 position = quantized * scale + offset
+void computeQuantization(const glm::vec3& min, const glm::vec3& max, glm::vec3& scale, glm::vec3& offset);
+
+// 把位置量化为int16，每个点写入4个int16（xyz和一个填充0，便于按4字节对齐），out至少包含4 * count个元素
+void quantizePositions(const glm::vec3* points, size_t count, const glm::vec3& scale, const glm::vec3& offset,
+                       int16_t* out);
+
+// 把[0, 1]范围的RGB颜色打包为RGBA8（内存中依次为r、g、b、a，a固定为255），超出范围的分量会被截断
+void packColorsRGBA8(const glm::vec3* colors, size_t count, uint32_t* out);
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "data/DataTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace mviz {
+
+// 点记录解码
+// 传感器驱动给出的点云是一块二进制数据加字段描述（与ROS sensor_msgs/PointCloud2相同：每个点占point_step字节，
+// 字段有名称、偏移、类型和元素个数）。解码器在构造时按字段描述选择解码函数：常见布局（xyz、xyzi、xyzrgb，
+// 紧凑或带填充）使用步长和偏移都在编译期确定的特化版本，其他布局使用逐字段按类型转换的通用版本。
+// 位置和颜色输出为GPU顶点格式（紧密排列的float xyz和RGBA8颜色，与PointCloudVisual的FLOAT32位置块和RGBA8颜色块相同），
+// 解码时同时求出包围盒，这两块可以直接写入映射的缓冲区，不需要回读。强度输出为float，对应CPU端的强度属性通道；
+// PointCloudVisual上传时再按取值范围量化为uint16属性块，因此强度不能直接写入暂存缓冲区。
+
+// 字段的数据类型，取值与PointCloud2的PointField相同
+enum class PointFieldType : uint8_t {
+    INT8 = 1,
+    UINT8 = 2,
+    INT16 = 3,
+    UINT16 = 4,
+    INT32 = 5,
+    UINT32 = 6,
+    FLOAT32 = 7,
+    FLOAT64 = 8
+};
+
+// 字段描述
+struct PointField {
+    std::string name;
+    uint32_t offset = 0;                           // 在点记录中的字节偏移
+    PointFieldType type = PointFieldType::FLOAT32;
+    uint32_t count = 1;                            // 元素个数
+};
+
+// 解码输出：指针为空时不输出该字段，否则至少包含count个元素；记录中没有颜色时输出白色，没有强度时输出0
+struct PointDecodeTarget {
+    glm::vec3* positions = nullptr;  // float xyz，与FLOAT32位置块相同
+    uint32_t* colors = nullptr;      // RGBA8（内存中依次为r、g、b、a），与RGBA8颜色块相同
+    float* intensity = nullptr;      // float，与强度属性通道相同（不是上传的uint16属性块）
+    
+    // 解码得到的包围盒，忽略NaN坐标（驱动常用NaN标记无效点）；没有有效点时保持不变
+    glm::vec3 min{0.0f};
+    glm::vec3 max{0.0f};
+};
+
+class PointRecordDecoder {
+public:
+    /**
+     * 按字段描述创建解码器
+     * @param fields 字段描述
+     * @param pointStep 每个点记录的字节数
+     * @param specialize 是否允许使用特化的解码函数（用于对比测试）
+     */
+    PointRecordDecoder(const std::vector<PointField>& fields, size_t pointStep, bool specialize = true);
+    
+    /**
+     * 字段描述是否包含可解码的x、y、z字段
+     * @return 是否有效
+     */
+    bool isValid() const { return m_valid; }
+    
+    /**
+     * 记录中是否有打包的颜色字段（rgb或rgba）
+     * @return 是否有颜色
+     */
+    bool hasColors() const { return m_rgb.present(); }
+    
+    /**
+     * 记录中是否有强度字段
+     * @return 是否有强度
+     */
+    bool hasIntensity() const { return m_intensity.present(); }
+    
+    /**
+     * 获取选中的布局名称，通用版本为"generic"
+     * @return 布局名称
+     */
+    const char* getLayoutName() const { return m_layoutName; }
+    
+    /**
+     * 是否使用特化的解码函数
+     * @return 是否特化
+     */
+    bool isSpecialized() const { return m_function != nullptr; }
+    
+    /**
+     * 解码位置、颜色和强度，格式见PointDecodeTarget
+     * @param data 点记录数据，至少包含count * pointStep字节
+     * @param count 点数
+     * @param target 输出位置，同时返回包围盒
+     */
+    void decode(const uint8_t* data, size_t count, PointDecodeTarget& target) const;
+    
+    /**
+     * 解码为点云数据：位置、颜色和强度，其他单元素字段按名称存入属性通道
+     * @param data 点记录数据
+     * @param count 点数
+     * @param pointCloud 输出的点云（原有的点和属性被替换）
+     */
+    void decode(const uint8_t* data, size_t count, PointCloudData& pointCloud) const;
+    
+    using DecodeFunction = void (*)(const uint8_t* data, size_t count, PointDecodeTarget& target);
+    
+private:
+    // 通用版本使用的字段：偏移和类型，offset为负表示不存在
+    struct FieldAccess {
+        long offset = -1;
+        PointFieldType type = PointFieldType::FLOAT32;
+        
+        bool present() const { return offset >= 0; }
+    };
+    
+    // 逐字段按类型转换的通用解码
+    void decodeGeneric(const uint8_t* data, size_t count, PointDecodeTarget& target) const;
+    
+    FieldAccess m_x;
+    FieldAccess m_y;
+    FieldAccess m_z;
+    FieldAccess m_intensity;
+    FieldAccess m_rgb;
+    
+    // 复制到属性通道的其他单元素字段
+    std::vector<PointField> m_extraFields;
+    
+    size_t m_pointStep;
+    bool m_valid;
+    const char* m_layoutName;
+    DecodeFunction m_function; // 特化的解码函数，为空时使用通用版本
+};
+
+} // namespace mviz 
\ No newline at end of file
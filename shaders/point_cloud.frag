@@ -1,6 +1,7 @@
 #version 330 core
 
 in vec3 fragColor;
+in float fragFade;
 out vec4 FragColor;
 
 void main() {
@@ -9,5 +10,5 @@ void main() {
     if(length(coord) > 0.5)
         discard;
         
-    FragColor = vec4(fragColor, 1.0);
+    FragColor = vec4(fragColor, fragFade);
 } 
\ No newline at end of file
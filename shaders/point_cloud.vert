@@ -1,16 +1,120 @@
 #version 330 core
 
+// 位置可能是float3，也可能是相对于包围盒量化的int16（以整数值读入）
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
+// 颜色为归一化的RGBA8，没有颜色属性时使用uniform_color
+layout (location = 1) in vec4 aColor;
+// 标量属性（强度、线束编号或标签），以uint16整数值读入
+layout (location = 2) in float aScalar;
+// 过滤用的标量属性，解码方式同上
+layout (location = 3) in float aFilterScalar;
 
 out vec3 fragColor;
+out float fragFade;
 
 uniform mat4 model;
 uniform mat4 view_projection;
 uniform float point_size;
 
+// 位置解码参数：position = aPos * position_scale + position_offset（float3时为单位缩放和零偏移）
+uniform vec3 position_scale;
+uniform vec3 position_offset;
+
+// 颜色模式：0为RGB属性，1为uniform_color，2为标量属性，3为沿height_axis的高度
+uniform int color_mode;
+uniform vec3 uniform_color;
+
+// 标量着色：value = aScalar * scalar_scale + scalar_bias，[scalar_min, scalar_max]映射到色表
+// 离散色表（标签）按整数值循环取色，不使用范围
+uniform sampler1D colormap;
+uniform bool colormap_discrete;
+uniform float scalar_scale;
+uniform float scalar_bias;
+uniform float scalar_min;
+uniform float scalar_max;
+uniform vec3 height_axis;
+
+// 点过滤（点云坐标系）：filter_flags的各位依次为裁剪框、距离带、标量阈值和裁剪平面
+uniform int filter_flags;
+uniform mat3 crop_inverse_rotation;
+uniform vec3 crop_center;
+uniform vec3 crop_half_size;
+uniform vec2 filter_range;
+uniform float filter_scalar_scale;
+uniform float filter_scalar_bias;
+uniform vec2 filter_scalar_range;
+uniform vec4 clip_plane;
+
+// 多帧累积：本帧点云的写入时间和当前时间（秒），decay_time为0时不淡出
+uniform float scan_time;
+uniform float current_time;
+uniform float decay_time;
+
+vec3 mapScalar(float value) {
+    int size = textureSize(colormap, 0);
+    if (colormap_discrete) {
+        int index = int(mod(floor(value + 0.5), float(size)));
+        return texelFetch(colormap, index, 0).rgb;
+    }
+    
+    // 采样纹素中心，使两端的颜色不被边缘过滤
+    float t = clamp((value - scalar_min) / max(scalar_max - scalar_min, 1e-6), 0.0, 1.0);
+    return texture(colormap, (t * float(size - 1) + 0.5) / float(size)).rgb;
+}
+
+bool passesFilter(vec3 position) {
+    if ((filter_flags & 1) != 0) {
+        vec3 local = crop_inverse_rotation * (position - crop_center);
+        if (any(greaterThan(abs(local), crop_half_size))) {
+            return false;
+        }
+    }
+    if ((filter_flags & 2) != 0) {
+        float range = length(position);
+        if (range < filter_range.x || range > filter_range.y) {
+            return false;
+        }
+    }
+    if ((filter_flags & 4) != 0) {
+        float value = aFilterScalar * filter_scalar_scale + filter_scalar_bias;
+        if (value < filter_scalar_range.x || value > filter_scalar_range.y) {
+            return false;
+        }
+    }
+    if ((filter_flags & 8) != 0 && dot(clip_plane.xyz, position) + clip_plane.w < 0.0) {
+        return false;
+    }
+    return true;
+}
+
 void main() {
-    gl_Position = view_projection * model * vec4(aPos, 1.0);
+    vec3 position = aPos * position_scale + position_offset;
+    
+    // 被过滤的点移到裁剪空间之外，由图元装配丢弃
+    if (filter_flags != 0 && !passesFilter(position)) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        fragColor = vec3(0.0);
+        fragFade = 0.0;
+        return;
+    }
+    
+    vec4 worldPosition = model * vec4(position, 1.0);
+    gl_Position = view_projection * worldPosition;
     gl_PointSize = point_size;
-    fragColor = aColor;
+    
+    if (color_mode == 0) {
+        fragColor = aColor.rgb;
+    } else if (color_mode == 2) {
+        fragColor = mapScalar(aScalar * scalar_scale + scalar_bias);
+    } else if (color_mode == 3) {
+        fragColor = mapScalar(dot(worldPosition.xyz, height_axis));
+    } else {
+        fragColor = uniform_color;
+    }
+    
+    // 按时间线性淡出，完全淡出的点移到裁剪空间之外
+    fragFade = decay_time > 0.0 ? 1.0 - (current_time - scan_time) / decay_time : 1.0;
+    if (fragFade <= 0.0) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    }
 } 
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <GLFW/glfw3.h>
 #include "rendering/Shader.h"
 #include "rendering/Renderer.h"
+#include "rendering/UploadWorker.h"
 #include "core/Camera.h"
 #include "core/TFManager.h"
 #include "core/SceneManager.h"
@@ -51,6 +52,7 @@ Application::~Application() {
     // 清理资源
     m_uiManager.reset();
     m_sceneManager.reset();
+    m_uploadWorker.reset(); // 在可视化对象之后销毁，执行完它们提交的清理任务
     m_renderer.reset();
     m_shader.reset();
     m_pointCloudShader.reset();
@@ -120,8 +122,12 @@ bool Application::initialize() {
         return false;
     }
     
+    // 创建后台上传线程，失败时所有上传都在渲染线程中进行
+    m_uploadWorker = UploadWorker::create(m_window);
+    
     // 初始化场景管理器
     m_sceneManager->setRenderer(m_renderer);
+    m_sceneManager->setUploadWorker(m_uploadWorker);
     m_sceneManager->setCamera(m_camera);
     if (!m_sceneManager->initialize()) {
         std::cerr << "Failed to initialize scene manager" << std::endl;
@@ -376,6 +382,9 @@ void Application::processMouseButton(int button, int action, int mods) {
         }
     }
     
+    // 按住任一按键拖动期间相机处于交互状态，场景以较低的点数绘制
+    m_camera->setInteracting(m_leftMousePressed || m_rightMousePressed);
+    
     // 如果所有按键都释放
     if (!m_leftMousePressed && !m_rightMousePressed && m_camera->getMode() == Camera::Mode::FPS) {
         // 在FPS模式下，默认捕获鼠标
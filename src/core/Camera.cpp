@@ -51,6 +51,10 @@ glm::mat4 Camera::getProjectionMatrix() const {
     return glm::perspective(glm::radians(m_fov), m_aspectRatio, m_nearPlane, m_farPlane);
 }
 
+Frustum Camera::getFrustum() const {
+    return Frustum::fromMatrix(getProjectionMatrix() * getViewMatrix());
+}
+
 void Camera::setPosition(const glm::vec3& position) {
     m_position = position;
     m_distance = glm::length(m_position - m_target);
@@ -0,0 +1,71 @@
+#include "core/CpuFeatures.h"
+
+#if defined(MVIZ_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace mviz {
+
+namespace {
+
+#if defined(MVIZ_X86) && defined(_MSC_VER)
+// CPUID第1页ECX和第7页EBX中的特性位
+constexpr int SSSE3_BIT = 1 << 9;
+constexpr int OSXSAVE_BIT = 1 << 27;
+constexpr int AVX_BIT = 1 << 28;
+constexpr int AVX2_BIT = 1 << 5;
+
+bool detectSSSE3() {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & SSSE3_BIT) != 0;
+}
+
+bool detectAVX2() {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    
+    // 操作系统必须在上下文切换时保存YMM寄存器
+    __cpuid(info, 1);
+    if ((info[2] & OSXSAVE_BIT) == 0 || (info[2] & AVX_BIT) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    
+    __cpuidex(info, 7, 0);
+    return (info[1] & AVX2_BIT) != 0;
+}
+#elif defined(MVIZ_X86)
+// __builtin_cpu_supports同时检查了操作系统对扩展寄存器的支持
+bool detectSSSE3() {
+    return __builtin_cpu_supports("ssse3");
+}
+
+bool detectAVX2() {
+    return __builtin_cpu_supports("avx2");
+}
+#else
+bool detectSSSE3() {
+    return false;
+}
+
+bool detectAVX2() {
+    return false;
+}
+#endif
+
+} // namespace
+
+bool cpuSupportsSSSE3() {
+    static const bool supported = detectSSSE3();
+    return supported;
+}
+
+bool cpuSupportsAVX2() {
+    static const bool supported = detectAVX2();
+    return supported;
+}
+
+} // namespace mviz 
\ No newline at end of file
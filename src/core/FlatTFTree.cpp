@@ -0,0 +1,215 @@
+#include "core/FlatTFTree.h"
+#include "core/CpuFeatures.h"
+#include "core/TFSnapshot.h"
+
+// AVX2路径只在propagate8中按目标指令集编译，运行时检查CPU后才调用
+#if defined(MVIZ_ENABLE_AVX2) && defined(MVIZ_X86)
+#define MVIZ_FLAT_TF_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace mviz {
+
+//-------------------- TransformArrays 实现 --------------------
+
+void FlatTFTree::TransformArrays::resize(size_t count) {
+    tx.resize(count);
+    ty.resize(count);
+    tz.resize(count);
+    qw.resize(count);
+    qx.resize(count);
+    qy.resize(count);
+    qz.resize(count);
+}
+
+Transform FlatTFTree::TransformArrays::get(size_t index) const {
+    return Transform(glm::vec3(tx[index], ty[index], tz[index]),
+                     glm::quat(qw[index], qx[index], qy[index], qz[index]));
+}
+
+void FlatTFTree::TransformArrays::set(size_t index, const Transform& transform) {
+    tx[index] = transform.translation.x;
+    ty[index] = transform.translation.y;
+    tz[index] = transform.translation.z;
+    qw[index] = transform.rotation.w;
+    qx[index] = transform.rotation.x;
+    qy[index] = transform.rotation.y;
+    qz[index] = transform.rotation.z;
+}
+
+//-------------------- FlatTFTree 实现 --------------------
+
+void FlatTFTree::build(const TFSnapshot& snapshot) {
+    const std::vector<FrameId> ids = snapshot.getAllFrameIds();
+    
+    // 按深度计数排序，同一深度内保持句柄顺序
+    m_levelOffsets.clear();
+    for (FrameId id : ids) {
+        size_t depth = snapshot.getFrame(id)->depth;
+        if (depth + 2 > m_levelOffsets.size()) {
+            m_levelOffsets.resize(depth + 2, 0);
+        }
+        ++m_levelOffsets[depth + 1];
+    }
+    for (size_t level = 1; level < m_levelOffsets.size(); ++level) {
+        m_levelOffsets[level] += m_levelOffsets[level - 1];
+    }
+    
+    const size_t count = ids.size();
+    m_frames.resize(count);
+    m_parents.resize(count);
+    m_roots.resize(count);
+    m_local.resize(count);
+    m_world.resize(count);
+    
+    std::vector<size_t> cursor(m_levelOffsets.begin(), m_levelOffsets.end());
+    m_indices.assign(ids.empty() ? 0 : ids.back().value + 1, -1);
+    for (FrameId id : ids) {
+        size_t index = cursor[snapshot.getFrame(id)->depth]++;
+        m_frames[index] = id;
+        m_indices[id.value] = static_cast<int32_t>(index);
+    }
+    
+    // 父节点位于更靠前的层，此时所有节点的下标都已确定
+    for (size_t index = 0; index < count; ++index) {
+        const TFFrameState* state = snapshot.getFrame(m_frames[index]);
+        m_parents[index] = state->parent.isValid() ? m_indices[state->parent.value] : NO_PARENT;
+        m_roots[index] = m_indices[state->root.value];
+        m_local.set(index, state->transform);
+        m_world.set(index, state->world);
+    }
+}
+
+bool FlatTFTree::setLocalTransform(FrameId frame, const Transform& transform) {
+    int32_t index = getIndex(frame);
+    if (index < 0) {
+        return false;
+    }
+    m_local.set(static_cast<size_t>(index), transform);
+    return true;
+}
+
+void FlatTFTree::computeWorldTransforms() {
+    if (m_levelOffsets.size() < 2) {
+        return;
+    }
+    
+    // 第0层为根节点，定义所在树的参考系
+    for (size_t index = 0; index < m_levelOffsets[1]; ++index) {
+        m_world.set(index, Transform());
+    }
+    
+#if defined(MVIZ_FLAT_TF_AVX2)
+    const bool avx2 = cpuSupportsAVX2();
+#endif
+    
+    // 逐层传播，同一层内的节点只依赖前面各层的结果
+    for (size_t level = 1; level + 1 < m_levelOffsets.size(); ++level) {
+        size_t index = m_levelOffsets[level];
+        const size_t end = m_levelOffsets[level + 1];
+        
+#if defined(MVIZ_FLAT_TF_AVX2)
+        if (avx2) {
+            for (; index + 8 <= end; index += 8) {
+                propagate8(index);
+            }
+        }
+#endif
+        for (; index < end; ++index) {
+            propagate(index);
+        }
+    }
+}
+
+bool FlatTFTree::lookupTransform(FrameId target_frame, FrameId source_frame, Transform& transform) const {
+    int32_t source = getIndex(source_frame);
+    int32_t target = getIndex(target_frame);
+    
+    // 两个坐标系都必须存在且位于同一棵树中
+    if (source < 0 || target < 0 || m_roots[source] != m_roots[target]) {
+        return false;
+    }
+    
+    if (source == target) {
+        transform = Transform(); // 单位变换
+        return true;
+    }
+    
+    transform = m_world.get(target).inverse() * m_world.get(source);
+    return true;
+}
+
+Transform FlatTFTree::getLocalTransform(size_t index) const {
+    return m_local.get(index);
+}
+
+Transform FlatTFTree::getWorldTransform(size_t index) const {
+    return m_world.get(index);
+}
+
+void FlatTFTree::propagate(size_t index) {
+    m_world.set(index, m_world.get(m_parents[index]) * m_local.get(index));
+}
+
+#if defined(MVIZ_FLAT_TF_AVX2)
+MVIZ_TARGET_AVX2 void FlatTFTree::propagate8(size_t begin) {
+    // 收集8个父节点的世界变换（不使用lambda：lambda不继承函数的目标指令集）
+    const __m256i parents = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m_parents.data() + begin));
+    const __m256 ptx = _mm256_i32gather_ps(m_world.tx.data(), parents, sizeof(float));
+    const __m256 pty = _mm256_i32gather_ps(m_world.ty.data(), parents, sizeof(float));
+    const __m256 ptz = _mm256_i32gather_ps(m_world.tz.data(), parents, sizeof(float));
+    const __m256 pqw = _mm256_i32gather_ps(m_world.qw.data(), parents, sizeof(float));
+    const __m256 pqx = _mm256_i32gather_ps(m_world.qx.data(), parents, sizeof(float));
+    const __m256 pqy = _mm256_i32gather_ps(m_world.qy.data(), parents, sizeof(float));
+    const __m256 pqz = _mm256_i32gather_ps(m_world.qz.data(), parents, sizeof(float));
+    
+    // 本节点的局部变换在数组中连续存放
+    const __m256 ltx = _mm256_loadu_ps(&m_local.tx[begin]);
+    const __m256 lty = _mm256_loadu_ps(&m_local.ty[begin]);
+    const __m256 ltz = _mm256_loadu_ps(&m_local.tz[begin]);
+    const __m256 lqw = _mm256_loadu_ps(&m_local.qw[begin]);
+    const __m256 lqx = _mm256_loadu_ps(&m_local.qx[begin]);
+    const __m256 lqy = _mm256_loadu_ps(&m_local.qy[begin]);
+    const __m256 lqz = _mm256_loadu_ps(&m_local.qz[begin]);
+    
+    // 旋转组合：q = q_parent * q_local（Hamilton积）
+    const __m256 qw = _mm256_sub_ps(_mm256_sub_ps(_mm256_sub_ps(
+        _mm256_mul_ps(pqw, lqw), _mm256_mul_ps(pqx, lqx)), _mm256_mul_ps(pqy, lqy)), _mm256_mul_ps(pqz, lqz));
+    const __m256 qx = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(
+        _mm256_mul_ps(pqw, lqx), _mm256_mul_ps(pqx, lqw)), _mm256_mul_ps(pqy, lqz)), _mm256_mul_ps(pqz, lqy));
+    const __m256 qy = _mm256_add_ps(_mm256_add_ps(_mm256_sub_ps(
+        _mm256_mul_ps(pqw, lqy), _mm256_mul_ps(pqx, lqz)), _mm256_mul_ps(pqy, lqw)), _mm256_mul_ps(pqz, lqx));
+    const __m256 qz = _mm256_add_ps(_mm256_sub_ps(_mm256_add_ps(
+        _mm256_mul_ps(pqw, lqz), _mm256_mul_ps(pqx, lqy)), _mm256_mul_ps(pqy, lqx)), _mm256_mul_ps(pqz, lqw));
+    
+    // 平移组合：t = t_parent + q_parent * t_local
+    // 用 v' = v + w * c + cross(u, c)，c = 2 * cross(u, v) 旋转向量，u为四元数的虚部
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 cx = _mm256_mul_ps(two, _mm256_sub_ps(_mm256_mul_ps(pqy, ltz), _mm256_mul_ps(pqz, lty)));
+    const __m256 cy = _mm256_mul_ps(two, _mm256_sub_ps(_mm256_mul_ps(pqz, ltx), _mm256_mul_ps(pqx, ltz)));
+    const __m256 cz = _mm256_mul_ps(two, _mm256_sub_ps(_mm256_mul_ps(pqx, lty), _mm256_mul_ps(pqy, ltx)));
+    
+    const __m256 rx = _mm256_add_ps(_mm256_add_ps(ltx, _mm256_mul_ps(pqw, cx)),
+                                    _mm256_sub_ps(_mm256_mul_ps(pqy, cz), _mm256_mul_ps(pqz, cy)));
+    const __m256 ry = _mm256_add_ps(_mm256_add_ps(lty, _mm256_mul_ps(pqw, cy)),
+                                    _mm256_sub_ps(_mm256_mul_ps(pqz, cx), _mm256_mul_ps(pqx, cz)));
+    const __m256 rz = _mm256_add_ps(_mm256_add_ps(ltz, _mm256_mul_ps(pqw, cz)),
+                                    _mm256_sub_ps(_mm256_mul_ps(pqx, cy), _mm256_mul_ps(pqy, cx)));
+    
+    _mm256_storeu_ps(&m_world.tx[begin], _mm256_add_ps(ptx, rx));
+    _mm256_storeu_ps(&m_world.ty[begin], _mm256_add_ps(pty, ry));
+    _mm256_storeu_ps(&m_world.tz[begin], _mm256_add_ps(ptz, rz));
+    _mm256_storeu_ps(&m_world.qw[begin], qw);
+    _mm256_storeu_ps(&m_world.qx[begin], qx);
+    _mm256_storeu_ps(&m_world.qy[begin], qy);
+    _mm256_storeu_ps(&m_world.qz[begin], qz);
+}
+#else
+void FlatTFTree::propagate8(size_t begin) {
+    for (size_t index = begin; index < begin + 8; ++index) {
+        propagate(index);
+    }
+}
+#endif
+
+} // namespace mviz 
\ No newline at end of file
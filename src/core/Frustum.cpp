@@ -0,0 +1,77 @@
+#include "core/Frustum.h"
+#include <cmath>
+
+namespace mviz {
+
+Frustum::Frustum() {
+    // 法向量为0、d为1的平面对任何点都成立
+    m_planes.fill(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4& clip) {
+    // glm为列主序，clip[c][r]是第r行第c列；裁剪空间中 -w <= x, y, z <= w
+    const glm::vec4 row0(clip[0][0], clip[1][0], clip[2][0], clip[3][0]);
+    const glm::vec4 row1(clip[0][1], clip[1][1], clip[2][1], clip[3][1]);
+    const glm::vec4 row2(clip[0][2], clip[1][2], clip[2][2], clip[3][2]);
+    const glm::vec4 row3(clip[0][3], clip[1][3], clip[2][3], clip[3][3]);
+    
+    Frustum frustum;
+    frustum.m_planes[LEFT_PLANE] = row3 + row0;
+    frustum.m_planes[RIGHT_PLANE] = row3 - row0;
+    frustum.m_planes[BOTTOM_PLANE] = row3 + row1;
+    frustum.m_planes[TOP_PLANE] = row3 - row1;
+    frustum.m_planes[NEAR_PLANE] = row3 + row2;
+    frustum.m_planes[FAR_PLANE] = row3 - row2;
+    
+    // 归一化后平面方程的值即为到平面的距离
+    for (glm::vec4& plane : frustum.m_planes) {
+        const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            plane = plane * (1.0f / length);
+        }
+    }
+    return frustum;
+}
+
+bool Frustum::intersectsBox(const glm::vec3& min, const glm::vec3& max) const {
+    for (const glm::vec4& plane : m_planes) {
+        // 取包围盒在平面法向量方向上最远的顶点，它在平面外侧时整个包围盒都在外侧
+        const glm::vec3 farthest(plane.x >= 0.0f ? max.x : min.x,
+                                 plane.y >= 0.0f ? max.y : min.y,
+                                 plane.z >= 0.0f ? max.z : min.z);
+        if (plane.x * farthest.x + plane.y * farthest.y + plane.z * farthest.z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::containsPoint(const glm::vec3& point) const {
+    for (const glm::vec4& plane : m_planes) {
+        if (plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void transformBox(const glm::mat4& transform, const glm::vec3& min, const glm::vec3& max,
+                  glm::vec3& outMin, glm::vec3& outMax) {
+    // 变换中心和半边长，半边长按旋转矩阵各元素的绝对值累加（Arvo方法）
+    const glm::vec3 center = (min + max) * 0.5f;
+    const glm::vec3 extent = (max - min) * 0.5f;
+    
+    glm::vec3 newCenter(transform[3]);
+    glm::vec3 newExtent(0.0f);
+    for (int c = 0; c < 3; ++c) {
+        for (int r = 0; r < 3; ++r) {
+            newCenter[r] += transform[c][r] * center[c];
+            newExtent[r] += std::abs(transform[c][r]) * extent[c];
+        }
+    }
+    
+    outMin = newCenter - newExtent;
+    outMax = newCenter + newExtent;
+}
+
+} // namespace mviz 
\ No newline at end of file
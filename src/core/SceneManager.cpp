@@ -1,7 +1,10 @@
 #include "core/SceneManager.h"
 #include "rendering/Renderer.h"
+#include "rendering/RenderTarget.h"
 #include "core/Camera.h"
+#include "core/Frustum.h"
 #include "visualization/PointCloudVisual.h"
+#include "visualization/OctreePointCloudVisual.h"
 #include "data/DataTypes.h"
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
@@ -9,33 +12,138 @@
 
 namespace mviz {
 
+namespace {
+
+// 默认的全局点数预算和目标帧率
+constexpr size_t DEFAULT_POINT_BUDGET = 10000000;
+constexpr float DEFAULT_TARGET_FRAME_RATE = 30.0f;
+
+// 相机运动时的默认点数预算
+constexpr size_t DEFAULT_INTERACTIVE_BUDGET = 2000000;
+
+// 按帧时间调整时预算的下限
+constexpr double MIN_POINT_BUDGET = 100000.0;
+
+// 帧时间的指数平滑系数，以及超出目标时每帧的缩小比例和有余量时每帧的增大比例
+constexpr double FRAME_TIME_SMOOTHING = 0.1;
+constexpr double BUDGET_DECREASE = 0.95;
+constexpr double BUDGET_INCREASE = 1.02;
+
+// 超过这个间隔的帧（如拖动窗口、断点）不计入帧时间
+constexpr double MAX_FRAME_INTERVAL = 0.5;
+
+// 包围盒投影到屏幕上的面积占视口的比例（按投影后的矩形估算），与近平面相交时视为覆盖整个视口
+float screenCoverage(const glm::mat4& clip, const glm::vec3& min, const glm::vec3& max) {
+    float left = 1.0f, right = -1.0f, bottom = 1.0f, top = -1.0f;
+    for (int corner = 0; corner < 8; ++corner) {
+        const glm::vec4 p = clip * glm::vec4(corner & 1 ? max.x : min.x,
+                                             corner & 2 ? max.y : min.y,
+                                             corner & 4 ? max.z : min.z, 1.0f);
+        if (p.w <= 1e-6f) {
+            return 1.0f;
+        }
+        left = std::min(left, p.x / p.w);
+        right = std::max(right, p.x / p.w);
+        bottom = std::min(bottom, p.y / p.w);
+        top = std::max(top, p.y / p.w);
+    }
+    
+    // 截取视口内的部分，NDC中视口的面积为4
+    const float width = std::max(std::min(right, 1.0f) - std::max(left, -1.0f), 0.0f);
+    const float height = std::max(std::min(top, 1.0f) - std::max(bottom, -1.0f), 0.0f);
+    return width * height * 0.25f;
+}
+
+} // namespace
+
 //-------------------- VisualObject 实现 --------------------
 
 VisualObject::VisualObject(const std::string& name, const std::string& frame_id)
     : m_name(name)
     , m_frame_id(frame_id)
     , m_visible(true)
+    , m_stamp(0.0)
     , m_model_matrix(1.0f) // 初始化为单位矩阵
+    , m_transform_applied(false)
+    , m_transform_available(true)
+    , m_frame_version(0)
+    , m_reference_version(0)
+    , m_applied_stamp(0.0)
 {
 }
 
-void VisualObject::update(TFManager& tf_manager, const std::string& reference_frame) {
-    // 查找从对象坐标系到参考坐标系的变换
-    Transform transform;
-    bool success = tf_manager.lookupTransform(reference_frame, m_frame_id, transform);
-    
-    if (success) {
-        // 如果找到变换，更新模型矩阵
-        m_model_matrix = transform.toMat4();
-    } else {
-        // 如果找不到变换，设置为单位矩阵并输出警告
-        m_model_matrix = glm::mat4(1.0f);
+FrameId VisualObject::resolveFrameId(TFManager& tf_manager) {
+    if (!m_frame_handle.isValid()) {
+        m_frame_handle = tf_manager.internFrame(m_frame_id);
+    }
+    return m_frame_handle;
+}
+
+void VisualObject::update(const TFSnapshot& tf_snapshot, FrameId reference_frame) {
+    // 变换链未改变时沿用上次的模型矩阵
+    if (!isTransformCurrent(tf_snapshot, reference_frame)) {
+        // 查找数据时刻从对象坐标系到参考坐标系的变换
+        Transform transform;
+        bool success = false;
+        if (m_stamp > 0.0) {
+            success = tf_snapshot.lookupTransform(reference_frame, m_frame_handle, m_stamp, transform);
+        }
         
-        // 特殊情况：如果frame_id就是reference_frame，不需要警告
-        if (m_frame_id != reference_frame) {
-            std::cerr << "Warning: Could not find transform from '" << m_frame_id 
-                      << "' to '" << reference_frame << "'" << std::endl;
+        // 未指定时刻或该时刻超出TF历史范围时，使用最新的变换
+        if (!success) {
+            success = tf_snapshot.lookupTransform(reference_frame, m_frame_handle, transform);
         }
+        
+        applyTransform(success, transform, tf_snapshot, reference_frame);
+    }
+    
+    updateResources();
+}
+
+bool VisualObject::isTransformCurrent(const TFSnapshot& tf_snapshot, FrameId reference_frame) const {
+    return m_transform_applied
+        && m_reference_handle == reference_frame
+        && m_applied_stamp == m_stamp
+        && m_frame_version == tf_snapshot.getFrameVersion(m_frame_handle)
+        && m_reference_version == tf_snapshot.getFrameVersion(reference_frame);
+}
+
+bool VisualObject::intersectsFrustum(const Frustum& frustum) const {
+    glm::vec3 min, max;
+    if (!getLocalBounds(min, max)) {
+        return true;
+    }
+    
+    glm::vec3 worldMin, worldMax;
+    transformBox(m_model_matrix, min, max, worldMin, worldMax);
+    return frustum.intersectsBox(worldMin, worldMax);
+}
+
+void VisualObject::applyTransform(bool found, const Transform& transform, const TFSnapshot& tf_snapshot,
+                                  FrameId reference_frame) {
+    // 找到变换时更新模型矩阵，否则设置为单位矩阵
+    m_model_matrix = found ? transform.toMat4() : glm::mat4(1.0f);
+    
+    // 可用性改变时通知，首次查找失败同样视为一次改变
+    if (found != m_transform_available) {
+        m_transform_available = found;
+        onTransformAvailabilityChanged(found, tf_snapshot, reference_frame);
+    }
+    
+    // 记录本次使用的状态
+    m_transform_applied = true;
+    m_reference_handle = reference_frame;
+    m_applied_stamp = m_stamp;
+    m_frame_version = tf_snapshot.getFrameVersion(m_frame_handle);
+    m_reference_version = tf_snapshot.getFrameVersion(reference_frame);
+}
+
+void VisualObject::onTransformAvailabilityChanged(bool available, const TFSnapshot& tf_snapshot,
+                                                  FrameId reference_frame) {
+    // 特殊情况：如果frame_id就是reference_frame，不需要警告
+    if (!available && m_frame_handle != reference_frame) {
+        std::cerr << "Warning: Could not find transform from '" << m_frame_id 
+                  << "' to '" << tf_snapshot.getFrameName(reference_frame) << "'" << std::endl;
     }
 }
 
@@ -47,9 +155,9 @@ AxesVisual::AxesVisual(const std::string& name, const std::string& frame_id, flo
 {
 }
 
-void AxesVisual::update(TFManager& tf_manager, const std::string& reference_frame) {
+void AxesVisual::update(const TFSnapshot& tf_snapshot, FrameId reference_frame) {
     // 调用基类的update方法更新模型矩阵
-    VisualObject::update(tf_manager, reference_frame);
+    VisualObject::update(tf_snapshot, reference_frame);
 }
 
 void AxesVisual::draw(Renderer& renderer, const glm::mat4& view_projection_matrix) {
@@ -63,7 +171,19 @@ void AxesVisual::draw(Renderer& renderer, const glm::mat4& view_projection_matri
 
 SceneManager::SceneManager()
     : m_reference_frame("world")
+    , m_point_budget(DEFAULT_POINT_BUDGET)
+    , m_target_frame_rate(DEFAULT_TARGET_FRAME_RATE)
+    , m_effective_budget(static_cast<double>(DEFAULT_POINT_BUDGET))
+    , m_frame_time(0.0)
+    , m_progressive_rendering(true)
+    , m_interactive_budget(DEFAULT_INTERACTIVE_BUDGET)
+    , m_progressive_view_projection(1.0f)
+    , m_progressive_viewport{0, 0, 0, 0}
+    , m_progressive_pass(0)
+    , m_progressive_passes(0)
+    , m_camera_moving(false)
 {
+    m_reference_frame_id = m_tf_manager.internFrame(m_reference_frame);
 }
 
 SceneManager::~SceneManager() {
@@ -83,9 +203,9 @@ bool SceneManager::initialize() {
 void SceneManager::setRenderer(std::shared_ptr<Renderer> renderer) {
     m_renderer = renderer;
     
-    // 将TF管理器设置到渲染器中
+    // 将当前的TF快照设置到渲染器中
     if (m_renderer) {
-        m_renderer->setTFManager(&m_tf_manager);
+        m_renderer->setTFSnapshot(m_tf_snapshot.get());
         m_renderer->setSceneManager(this);
     }
 }
@@ -128,7 +248,7 @@ void SceneManager::createDemoTFs() {
     Transform base_to_sensor;
     base_to_sensor.translation = glm::vec3(1.0f, 0.5f, 0.0f);
     base_to_sensor.rotation = glm::quat(0.707f, 0.0f, 0.707f, 0.0f); // 单位四元数   
-    m_tf_manager.addTransform("base_link", "sensor", base_to_sensor);
+    m_tf_manager.addStaticTransform("base_link", "sensor", base_to_sensor);
     
     // 定义变换: base_link -> left_wheel
     Transform base_to_left_wheel;
@@ -151,6 +271,7 @@ void SceneManager::createDemoTFs() {
 
 void SceneManager::setReferenceFrame(const std::string& frame) {
     m_reference_frame = frame;
+    m_reference_frame_id = m_tf_manager.internFrame(frame);
 }
 
 std::vector<std::string> SceneManager::getAvailableFrames() const {
@@ -158,15 +279,55 @@ std::vector<std::string> SceneManager::getAvailableFrames() const {
 }
 
 void SceneManager::update() {
-    // 更新所有可视化对象
+    // 获取本帧的TF快照，更新和渲染都基于同一个版本，不会看到修改到一半的TF树
+    m_tf_snapshot.reset();
+    m_tf_snapshot = m_tf_manager.acquireSnapshot();
+    const TFSnapshot& snapshot = *m_tf_snapshot;
+    
+    // 收集需要重新查找最新变换的对象所在的坐标系（按句柄去重）
+    constexpr size_t NO_SLOT = static_cast<size_t>(-1);
+    m_batch_frames.clear();
+    m_batch_objects.clear();
+    
     for (auto& [name, object] : m_visual_objects) {
-        if (object) {
-            object->update(m_tf_manager, m_reference_frame);
+        if (!object) continue;
+        
+        // 带时间戳的对象单独查找，变换链未改变的对象直接沿用上次的变换
+        FrameId frame = object->resolveFrameId(m_tf_manager);
+        if (object->getStamp() > 0.0 || object->isTransformCurrent(snapshot, m_reference_frame_id)) {
+            object->update(snapshot, m_reference_frame_id);
+            continue;
         }
+        
+        if (frame.value >= m_frame_slots.size()) {
+            m_frame_slots.resize(m_tf_manager.getFrameIdCount(), NO_SLOT);
+        }
+        
+        size_t& slot = m_frame_slots[frame.value];
+        if (slot == NO_SLOT) {
+            slot = m_batch_frames.size();
+            m_batch_frames.push_back(frame);
+        }
+        m_batch_objects.emplace_back(object.get(), slot);
+    }
+    
+    // 每个不同的坐标系只查找一次
+    snapshot.lookupTransforms(m_reference_frame_id, m_batch_frames, m_batch_transforms, m_batch_found);
+    
+    // 更新所有可视化对象
+    for (const auto& [object, slot] : m_batch_objects) {
+        object->applyTransform(m_batch_found[slot], m_batch_transforms[slot], snapshot, m_reference_frame_id);
+        object->updateResources();
+    }
+    
+    // 重置本帧用到的槽位
+    for (FrameId frame : m_batch_frames) {
+        m_frame_slots[frame.value] = NO_SLOT;
     }
     
     // 更新渲染器中的TF可视化数据
     if (m_renderer) {
+        m_renderer->setTFSnapshot(m_tf_snapshot.get());
         m_renderer->createTFVisualization();
     }
 }
@@ -181,6 +342,42 @@ void SceneManager::render() {
     glm::mat4 view = m_camera->getViewMatrix();
     glm::mat4 projection = m_camera->getProjectionMatrix();
     glm::mat4 view_projection = projection * view;
+    const Frustum frustum = Frustum::fromMatrix(view_projection);
+    
+    // 跳过包围盒完全在视锥体外的对象，支持分段绘制的点云单独列出
+    m_render_list.clear();
+    m_progressive_list.clear();
+    for (auto& [name, object] : m_visual_objects) {
+        if (!object || !object->isVisible() || !object->intersectsFrustum(frustum)) {
+            continue;
+        }
+        
+        auto cloud = m_progressive_rendering ? dynamic_cast<PointCloudVisual*>(object.get()) : nullptr;
+        if (cloud && cloud->supportsDrawSlices()) {
+            m_progressive_list.push_back(cloud);
+        } else {
+            m_render_list.push_back(object.get());
+        }
+    }
+    
+    // 按上一帧的帧时间调整预算；相机运动或离屏目标不可用时所有点云都直接绘制
+    updateFrameTime();
+    const bool progressive = updateProgressiveState(view_projection);
+    if (!progressive) {
+        m_render_list.insert(m_render_list.end(), m_progressive_list.begin(), m_progressive_list.end());
+    }
+    
+    // 把预算分给直接绘制的点云，相机运动时使用交互预算
+    size_t budget = getEffectivePointBudget();
+    if (m_camera_moving && m_interactive_budget > 0) {
+        budget = budget > 0 ? std::min(budget, m_interactive_budget) : m_interactive_budget;
+    }
+    distributePointBudget(view_projection, budget);
+    
+    // 离屏图像包含深度，先复制到默认帧缓冲区，之后直接绘制的对象与其正确遮挡
+    if (progressive) {
+        renderProgressivePass(view_projection);
+    }
     
     // 绘制地面网格
     m_renderer->drawGroundGrid(m_reference_frame);
@@ -189,10 +386,171 @@ void SceneManager::render() {
     m_renderer->drawTFVisualization();
     
     // 绘制所有可视化对象
-    for (auto& [name, object] : m_visual_objects) {
-        if (object && object->isVisible()) {
-            object->draw(*m_renderer, view_projection);
+    for (VisualObject* object : m_render_list) {
+        object->draw(*m_renderer, view_projection);
+    }
+}
+
+void SceneManager::setProgressiveRendering(bool enabled) {
+    m_progressive_rendering = enabled;
+    if (!enabled) {
+        m_progressive_target.reset();
+        m_progressive_entries.clear();
+        m_progressive_passes = 0;
+    }
+}
+
+bool SceneManager::updateProgressiveState(const glm::mat4& view_projection) {
+    // 正在拖动、视图投影矩阵或视口改变时视为相机在运动
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const bool viewportChanged = !std::equal(viewport, viewport + 4, m_progressive_viewport);
+    m_camera_moving = m_camera->isInteracting() || view_projection != m_progressive_view_projection || viewportChanged;
+    m_progressive_view_projection = view_projection;
+    std::copy(viewport, viewport + 4, m_progressive_viewport);
+    
+    // 点云集合或任一点云的绘制结果改变时，之前绘制的段作废
+    m_progressive_scratch.clear();
+    for (const PointCloudVisual* cloud : m_progressive_list) {
+        m_progressive_scratch.push_back(ProgressiveEntry{cloud, cloud->getRevision(), cloud->getModelMatrix()});
+    }
+    const bool unchanged = std::equal(m_progressive_scratch.begin(), m_progressive_scratch.end(),
+                                      m_progressive_entries.begin(), m_progressive_entries.end(),
+                                      [](const ProgressiveEntry& a, const ProgressiveEntry& b) {
+                                          return a.cloud == b.cloud && a.revision == b.revision && a.model == b.model;
+                                      });
+    m_progressive_entries.swap(m_progressive_scratch);
+    if (!unchanged || m_camera_moving || m_progressive_list.empty()) {
+        m_progressive_passes = 0;
+    }
+    if (m_camera_moving || m_progressive_list.empty()) {
+        return false;
+    }
+    
+    if (!m_progressive_target) {
+        m_progressive_target = std::make_unique<RenderTarget>();
+    }
+    if (!m_progressive_target->resize(viewport[2], viewport[3])) {
+        return false;
+    }
+    
+    // 开始新的一轮：按当前预算把所有点分为若干段，每帧绘制一段
+    if (m_progressive_passes == 0) {
+        size_t total = 0;
+        for (const PointCloudVisual* cloud : m_progressive_list) {
+            total += cloud->getPointCount();
+        }
+        const size_t budget = getEffectivePointBudget();
+        m_progressive_passes = budget > 0 ? std::max<size_t>((total + budget - 1) / budget, 1) : 1;
+        m_progressive_pass = 0;
+    }
+    return true;
+}
+
+void SceneManager::renderProgressivePass(const glm::mat4& view_projection) {
+    if (m_progressive_pass < m_progressive_passes) {
+        m_progressive_target->bind();
+        glViewport(0, 0, m_progressive_target->getWidth(), m_progressive_target->getHeight());
+        if (m_progressive_pass == 0) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+        
+        // 块内的点已被打乱，每一段都是整个点云的均匀子集，各段按深度测试叠加
+        const double begin = static_cast<double>(m_progressive_pass) / m_progressive_passes;
+        const double end = static_cast<double>(m_progressive_pass + 1) / m_progressive_passes;
+        for (PointCloudVisual* cloud : m_progressive_list) {
+            cloud->setDrawSlice(begin, end);
+            cloud->draw(*m_renderer, view_projection);
+            cloud->setDrawSlice(0.0, 1.0);
         }
+        ++m_progressive_pass;
+        
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(m_progressive_viewport[0], m_progressive_viewport[1], m_progressive_viewport[2],
+                   m_progressive_viewport[3]);
+    }
+    
+    m_progressive_target->blitToDefault(m_progressive_viewport[0], m_progressive_viewport[1]);
+}
+
+void SceneManager::setPointBudget(size_t budget) {
+    m_point_budget = budget;
+    m_effective_budget = static_cast<double>(budget);
+}
+
+void SceneManager::updateFrameTime() {
+    const auto now = std::chrono::steady_clock::now();
+    const double interval = std::chrono::duration<double>(now - m_last_render).count();
+    const bool measured = m_last_render.time_since_epoch().count() != 0;
+    m_last_render = now;
+    
+    if (measured && interval < MAX_FRAME_INTERVAL) {
+        m_frame_time = m_frame_time > 0.0 ? m_frame_time + FRAME_TIME_SMOOTHING * (interval - m_frame_time) : interval;
+    }
+    
+    if (m_point_budget == 0 || m_target_frame_rate <= 0.0f || m_frame_time <= 0.0) {
+        m_effective_budget = static_cast<double>(m_point_budget);
+        return;
+    }
+    
+    // 超出目标时缩小，低于目标的90%时增大，中间保持不变，避免在目标附近来回振荡
+    const double targetTime = 1.0 / m_target_frame_rate;
+    if (m_frame_time > targetTime) {
+        m_effective_budget *= BUDGET_DECREASE;
+    } else if (m_frame_time < 0.9 * targetTime) {
+        m_effective_budget *= BUDGET_INCREASE;
+    }
+    const double maxBudget = static_cast<double>(m_point_budget);
+    m_effective_budget = std::clamp(m_effective_budget, std::min(MIN_POINT_BUDGET, maxBudget), maxBudget);
+}
+
+void SceneManager::distributePointBudget(const glm::mat4& view_projection, size_t budget) {
+    struct Share {
+        PointCloudVisual* cloud;
+        size_t demand;  // 不限制时绘制的点数
+        float weight;   // 屏幕覆盖面积
+    };
+    
+    std::vector<Share> shares;
+    for (VisualObject* object : m_render_list) {
+        if (auto cloud = dynamic_cast<PointCloudVisual*>(object)) {
+            cloud->setPointBudget(0);
+            
+            // 没有包围盒（如累积模式）时按覆盖整个视口计算；很小的点云也保留最低的权重
+            glm::vec3 min, max;
+            float coverage = 1.0f;
+            if (cloud->getLocalBounds(min, max)) {
+                coverage = screenCoverage(view_projection * cloud->getModelMatrix(), min, max);
+            }
+            shares.push_back(Share{cloud, cloud->getDrawablePointCount(), std::max(coverage, 1e-4f)});
+        }
+    }
+    
+    size_t total = 0;
+    for (const Share& share : shares) {
+        total += share.demand;
+    }
+    if (budget == 0 || total <= budget) {
+        return;
+    }
+    
+    // 按面积比例分配，点数少于分到的份额的点云全部绘制，剩余部分再按比例分给其他点云：
+    // 按点数与权重之比从小到大处理，每个点云分到的份额不会少于按比例计算的值
+    std::sort(shares.begin(), shares.end(), [](const Share& a, const Share& b) {
+        return a.demand * b.weight < b.demand * a.weight;
+    });
+    
+    double remainingBudget = static_cast<double>(budget);
+    double remainingWeight = 0.0;
+    for (const Share& share : shares) {
+        remainingWeight += share.weight;
+    }
+    for (const Share& share : shares) {
+        const double portion = remainingBudget * share.weight / remainingWeight;
+        const size_t allotted = std::max<size_t>(std::min(share.demand, static_cast<size_t>(portion)), 1);
+        share.cloud->setPointBudget(allotted);
+        remainingBudget = std::max(remainingBudget - static_cast<double>(allotted), 0.0);
+        remainingWeight -= share.weight;
     }
 }
 
@@ -255,6 +613,14 @@ void SceneManager::createDemoPointCloud() {
     // 设置点的数量
     const int numPoints = 1000;
     
+    // 标量属性：强度随距离衰减，标签为点所在的象限
+    pointCloud.addAttribute(ATTRIBUTE_INTENSITY, AttributeType::FLOAT32);
+    pointCloud.addAttribute(ATTRIBUTE_LABEL, AttributeType::UINT16);
+    PointAttribute& intensity = *pointCloud.findAttribute(ATTRIBUTE_INTENSITY);
+    PointAttribute& label = *pointCloud.findAttribute(ATTRIBUTE_LABEL);
+    intensity.reserve(numPoints);
+    label.reserve(numPoints);
+    
     // 生成随机点
     for (int i = 0; i < numPoints; ++i) {
         // 生成随机点位置（球形分布）
@@ -275,13 +641,23 @@ void SceneManager::createDemoPointCloud() {
             colorDist(gen),
             colorDist(gen)
         ));
+        
+        // 添加标量属性
+        intensity.push_back(1.0f - r / 0.7f);
+        label.push_back(static_cast<uint16_t>((x >= 0.0f) + 2 * (y >= 0.0f) + 4 * (z >= 0.0f)));
     }
     
     // 设置点的大小
     pointCloud.pointSize = 2.0f;
     
-    // 将点云数据设置到可视化对象中
-    pointCloudVisual->setPointCloud(pointCloud);
+    // 有上传线程时在后台打包和上传
+    if (m_upload_worker) {
+        pointCloudVisual->setUploadWorker(m_upload_worker);
+        pointCloudVisual->setUpdateMode(PointCloudVisual::UpdateMode::ASYNC);
+    }
+    
+    // 将点云数据移入可视化对象中
+    pointCloudVisual->setPointCloud(std::move(pointCloud));
     
     // 将点云可视化对象添加到场景中
     addVisualObject(pointCloudVisual);
@@ -289,4 +665,18 @@ void SceneManager::createDemoPointCloud() {
     std::cout << "Created demo point cloud with " << numPoints << " points" << std::endl;
 }
 
+bool SceneManager::loadOctreePointCloud(const std::string& name, const std::string& frame_id, const std::string& path) {
+    auto octreeVisual = std::make_shared<OctreePointCloudVisual>(name, frame_id);
+    octreeVisual->setCamera(m_camera);
+    octreeVisual->setUploadWorker(m_upload_worker);
+    if (!octreeVisual->open(path)) {
+        return false;
+    }
+    
+    addVisualObject(octreeVisual);
+    
+    std::cout << "Opened octree point cloud with " << octreeVisual->getTotalPointCount() << " points: " << path << std::endl;
+    return true;
+}
+
 } // namespace mviz 
\ No newline at end of file
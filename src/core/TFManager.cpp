@@ -1,47 +1,19 @@
 #include "core/TFManager.h"
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtx/matrix_decompose.hpp>
 #include <algorithm>
 #include <iostream>
-#include <queue>
+#include <thread>
 
 namespace mviz {
 
-//-------------------- Transform 实现 --------------------
-
-glm::mat4 Transform::toMat4() const {
-    // 创建从旋转四元数得到的旋转矩阵
-    glm::mat4 rotMat = glm::mat4_cast(rotation);
-    
-    // 设置平移部分
-    rotMat[3][0] = translation.x;
-    rotMat[3][1] = translation.y;
-    rotMat[3][2] = translation.z;
-    
-    return rotMat;
-}
-
-Transform Transform::operator*(const Transform& other) const {
-    // 组合变换
-    Transform result;
-    result.rotation = rotation * other.rotation;
-    result.translation = translation + rotation * other.translation;
-    return result;
-}
-
-Transform Transform::inverse() const {
-    // 反转变换
-    Transform result;
-    result.rotation = glm::inverse(rotation);
-    result.translation = -(result.rotation * translation);
-    return result;
-}
-
 //-------------------- TransformNode 实现 --------------------
 
-TransformNode::TransformNode(const std::string& name)
-    : m_name(name)
+TransformNode::TransformNode(FrameId id, const std::string& name)
+    : m_id(id)
+    , m_name(name)
     , m_parent(nullptr)
+    , m_root(nullptr)
+    , m_depth(0)
+    , m_worldDirty(true)
 {
 }
 
@@ -50,18 +22,27 @@ TransformNode::~TransformNode() {
 }
 
 void TransformNode::setParent(TransformNode* parent, const Transform& transform) {
-    // 如果有旧的父节点，从它的子节点列表中移除自己
-    if (m_parent) {
-        m_parent->removeChild(m_name);
+    // 父节点改变时才需要更新子节点列表，避免线性查找
+    if (m_parent != parent) {
+        // 如果有旧的父节点，从它的子节点列表中移除自己
+        if (m_parent) {
+            m_parent->removeChild(this);
+        }
+        
+        // 父节点改变后原有的历史记录不再有意义
+        m_history.clear();
+        m_parent = parent;
+        
+        // 如果有新的父节点，将自己添加到它的子节点列表中
+        if (m_parent) {
+            m_parent->addChild(this);
+        }
     }
     
-    m_parent = parent;
     m_transform = transform;
     
-    // 如果有新的父节点，将自己添加到它的子节点列表中
-    if (m_parent) {
-        m_parent->addChild(this);
-    }
+    // 父节点或变换改变，整个子树的缓存失效
+    invalidateWorldTransform();
 }
 
 void TransformNode::addChild(TransformNode* child) {
@@ -72,245 +53,565 @@ void TransformNode::addChild(TransformNode* child) {
     }
 }
 
-void TransformNode::removeChild(const std::string& name) {
-    m_children.erase(
-        std::remove_if(m_children.begin(), m_children.end(),
-            [&name](const TransformNode* node) { return node->getName() == name; }),
-        m_children.end()
-    );
+void TransformNode::removeChild(const TransformNode* child) {
+    m_children.erase(std::remove(m_children.begin(), m_children.end(), child), m_children.end());
 }
 
 void TransformNode::setTransform(const Transform& transform) {
     m_transform = transform;
+    invalidateWorldTransform();
+}
+
+const Transform& TransformNode::getWorldTransform() const {
+    if (m_worldDirty) {
+        updateWorldTransform();
+    }
+    return m_worldTransform;
+}
+
+const TransformNode* TransformNode::getRoot() const {
+    if (m_worldDirty) {
+        updateWorldTransform();
+    }
+    return m_root;
+}
+
+uint32_t TransformNode::getDepth() const {
+    if (m_worldDirty) {
+        updateWorldTransform();
+    }
+    return m_depth;
 }
 
+void TransformNode::invalidateWorldTransform() {
+    // 已失效的节点其子树必然也已失效，无需继续向下传播
+    if (m_worldDirty) {
+        return;
+    }
+    
+    // 使用显式栈避免深层链条导致递归过深
+    std::vector<TransformNode*> stack{this};
+    while (!stack.empty()) {
+        TransformNode* node = stack.back();
+        stack.pop_back();
+        node->m_worldDirty = true;
+        
+        for (TransformNode* child : node->m_children) {
+            if (!child->m_worldDirty) {
+                stack.push_back(child);
+            }
+        }
+    }
+}
+
+void TransformNode::updateWorldTransform() const {
+    // 向上收集所有缓存失效的祖先节点，然后自顶向下依次计算
+    std::vector<const TransformNode*> chain;
+    for (const TransformNode* node = this; node && node->m_worldDirty; node = node->m_parent) {
+        chain.push_back(node);
+    }
+    
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        const TransformNode* node = *it;
+        if (node->m_parent) {
+            node->m_worldTransform = node->m_parent->m_worldTransform * node->m_transform;
+            node->m_root = node->m_parent->m_root;
+            node->m_depth = node->m_parent->m_depth + 1;
+        } else {
+            // 根节点定义所在树的参考系
+            node->m_worldTransform = Transform();
+            node->m_root = node;
+            node->m_depth = 0;
+        }
+        node->m_worldDirty = false;
+    }
+}
+
+
 //-------------------- TFManager 实现 --------------------
 
-TFManager::TFManager() {
-    // 创建世界坐标系节点
-    m_worldNode = findOrCreateNode("world");
+TFManager::TFManager()
+    : m_worldNode(nullptr)
+    , m_bufferDuration(TransformBuffer::DEFAULT_MAX_DURATION)
+    , m_bufferMaxSamples(TransformBuffer::DEFAULT_MAX_SAMPLES)
+    , m_topologyChanged(false)
+    , m_current(nullptr)
+    , m_epoch(1)
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    
+    // 创建世界坐标系节点并发布第一个快照
+    m_worldFrame = internFrame("world");
+    m_worldNode = findOrCreateNode(m_worldFrame);
+    publish();
 }
 
 TFManager::~TFManager() {
+    // 析构时不应再有读者持有快照
+    delete m_current.exchange(nullptr);
+    for (const auto& retired : m_retired) {
+        delete retired.second;
+    }
+    m_retired.clear();
+    
     // 清理节点
     m_nodes.clear();
     m_worldNode = nullptr;
 }
 
+TFSnapshotReader TFManager::acquireSnapshot() const {
+    for (;;) {
+        for (TFReaderSlot& slot : m_readerSlots) {
+            bool expected = false;
+            if (!slot.active.load(std::memory_order_relaxed) &&
+                slot.active.compare_exchange_strong(expected, true)) {
+                // 先公布观察到的纪元，再读取快照指针，写入端据此判断旧快照是否仍可能被持有
+                slot.epoch.store(m_epoch.load());
+                return TFSnapshotReader(&slot, m_current.load());
+            }
+        }
+        
+        // 所有槽位都被占用，等待其他读者释放
+        std::this_thread::yield();
+    }
+}
+
+FrameId TFManager::internFrame(const std::string& frame) {
+    return m_frameNames.intern(frame);
+}
+
 void TFManager::addTransform(const std::string& parent_frame, const std::string& child_frame, 
                             const Transform& transform) {
+    addTransform(internFrame(parent_frame), internFrame(child_frame), transform);
+}
+
+void TFManager::addTransform(const std::string& parent_frame, const std::string& child_frame, 
+                            const Transform& transform, double stamp) {
+    addTransform(internFrame(parent_frame), internFrame(child_frame), transform, stamp);
+}
+
+void TFManager::addTransform(FrameId parent_frame, FrameId child_frame, const Transform& transform) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    applyUpdate(parent_frame, child_frame, transform, false, 0.0);
+    publish();
+}
+
+void TFManager::addTransform(FrameId parent_frame, FrameId child_frame, const Transform& transform,
+                            double stamp) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    applyUpdate(parent_frame, child_frame, transform, true, stamp);
+    publish();
+}
+
+void TFManager::addStaticTransform(const std::string& parent_frame, const std::string& child_frame,
+                                   const Transform& transform) {
+    addStaticTransform(internFrame(parent_frame), internFrame(child_frame), transform);
+}
+
+void TFManager::addStaticTransform(FrameId parent_frame, FrameId child_frame, const Transform& transform) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    applyUpdate(parent_frame, child_frame, transform, false, 0.0);
+    publish();
+}
+
+void TFManager::applyBatch(const std::vector<TransformUpdate>& updates) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    
+    // 先应用所有更新，子树失效在已失效的节点处提前结束，整批只发布一次
+    for (const TransformUpdate& update : updates) {
+        applyUpdate(update.parent, update.child, update.transform, update.stamp > 0.0, update.stamp);
+    }
+    
+    publish();
+}
+
+void TFManager::applyUpdate(FrameId parent_frame, FrameId child_frame, const Transform& transform,
+                            bool stamped, double stamp) {
     // 查找或创建父节点和子节点
     TransformNode* parentNode = findOrCreateNode(parent_frame);
     TransformNode* childNode = findOrCreateNode(child_frame);
     
-    // 设置子节点的父节点和变换关系
-    childNode->setParent(parentNode, transform);
-}
-
-void TFManager::removeTransform(const std::string& frame) {
-    // 不能删除世界坐标系
-    if (frame == "world") {
+    // 父节点改变时才可能形成环，拒绝这样的变换
+    if (childNode->getParent() != parentNode && wouldCreateCycle(parentNode, childNode)) {
+        std::cerr << "Warning: Ignoring transform '" << parentNode->getName() << "' -> '"
+                  << childNode->getName() << "' because it would create a cycle" << std::endl;
         return;
     }
     
-    auto it = m_nodes.find(frame);
-    if (it != m_nodes.end()) {
-        TransformNode* node = it->second.get();
+    if (childNode->getParent() != parentNode) {
+        m_topologyChanged = true;
+    }
+    
+    if (!stamped) {
+        // 设置子节点的父节点和变换关系，该边不再随时间变化
+        childNode->setParent(parentNode, transform);
+        childNode->getHistory().clear();
+    } else {
+        // 父节点改变时重新连接（会清空历史记录）
+        if (childNode->getParent() != parentNode) {
+            childNode->setParent(parentNode, transform);
+        }
         
-        // 获取父节点和子节点
-        TransformNode* parent = node->getParent();
-        const auto& children = node->getChildren();
+        TransformBuffer& history = childNode->getHistory();
+        history.insert(stamp, transform);
         
-        // 将子节点重新连接到父节点
-        if (parent) {
-            for (TransformNode* child : children) {
-                // 计算子节点相对于父节点的新变换
-                Transform parentToNode = node->getTransform();
-                Transform nodeToChild = child->getTransform();
-                Transform parentToChild = parentToNode * nodeToChild;
-                
-                // 更新子节点的父节点和变换
-                child->setParent(parent, parentToChild);
-            }
-            
-            // 从父节点的子节点列表中移除自己
-            parent->removeChild(frame);
-        } else {
-            // 如果没有父节点（这应该只可能是世界坐标系），将子节点变成独立节点
-            for (TransformNode* child : children) {
-                child->setParent(nullptr, child->getTransform());
-            }
+        // 最新样本作为该边的当前变换
+        if (history.newest().stamp == stamp) {
+            childNode->setTransform(transform);
         }
-        
-        // 从节点映射表中移除
-        m_nodes.erase(it);
     }
+    
+    // 即使只是插入了较旧的样本，子树中各坐标系在该时刻的变换也会改变，整个子树的版本都需要更新
+    markChanged(child_frame, true);
 }
 
-bool TFManager::lookupTransform(const std::string& target_frame, const std::string& source_frame,
-                               Transform& transform) const {
-    // 特殊情况：源和目标是同一个坐标系
-    if (target_frame == source_frame) {
-        transform = Transform(); // 单位变换
-        return true;
-    }
+void TFManager::setBufferLimits(double max_duration, size_t max_samples) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
     
-    // 查找源和目标节点
-    const TransformNode* sourceNode = findNode(source_frame);
-    const TransformNode* targetNode = findNode(target_frame);
+    m_bufferDuration = max_duration;
+    m_bufferMaxSamples = max_samples;
     
-    if (!sourceNode || !targetNode) {
-        return false; // 未找到节点
+    for (auto& node : m_nodes) {
+        if (node) {
+            node->getHistory().setLimits(max_duration, max_samples);
+            markChanged(node->getId(), false);
+        }
     }
     
-    // 查找从source到target的路径
-    std::vector<std::pair<const TransformNode*, bool>> path;
-    if (!findTransformPath(targetNode, sourceNode, path)) {
-        return false; // 无法找到路径
+    publish();
+}
+
+void TFManager::removeTransform(const std::string& frame) {
+    removeTransform(findFrameId(frame));
+}
+
+void TFManager::removeTransform(FrameId frame) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    
+    TransformNode* node = getNode(frame);
+    
+    // 不能删除世界坐标系
+    if (!node || node == m_worldNode) {
+        return;
     }
     
-    // 沿路径计算最终变换
-    transform = Transform(); // 初始为单位变换
+    // 获取父节点和子节点（复制子节点列表，重新设置父节点时会修改原列表）
+    TransformNode* parent = node->getParent();
+    const std::vector<TransformNode*> children = node->getChildren();
     
-    for (const auto& [node, inverse] : path) {
-        if (inverse) {
-            // 如果方向是反向的，使用逆变换
-            transform = transform * node->getTransform().inverse();
-        } else {
-            // 正向使用常规变换
-            transform = transform * node->getTransform();
+    // 将子节点重新连接到父节点
+    if (parent) {
+        for (TransformNode* child : children) {
+            // 计算子节点相对于父节点的新变换
+            Transform parentToNode = node->getTransform();
+            Transform nodeToChild = child->getTransform();
+            Transform parentToChild = parentToNode * nodeToChild;
+            
+            // 更新子节点的父节点和变换
+            child->setParent(parent, parentToChild);
+            m_topologyChanged = true;
+            markChanged(child->getId(), true);
+        }
+        
+        // 从父节点的子节点列表中移除自己
+        parent->removeChild(node);
+    } else {
+        // 如果没有父节点，将子节点变成独立节点
+        for (TransformNode* child : children) {
+            child->setParent(nullptr, child->getTransform());
+            m_topologyChanged = true;
+            markChanged(child->getId(), true);
         }
     }
     
-    return true;
+    // 释放节点，句柄保留以便坐标系重新出现时复用
+    m_nodes[frame.value].reset();
+    markChanged(frame, false);
+    publish();
+}
+
+bool TFManager::lookupTransform(const std::string& target_frame, const std::string& source_frame,
+                               Transform& transform) const {
+    return lookupTransform(findFrameId(target_frame), findFrameId(source_frame), transform);
+}
+
+bool TFManager::lookupTransform(FrameId target_frame, FrameId source_frame, Transform& transform) const {
+    return acquireSnapshot()->lookupTransform(target_frame, source_frame, transform);
+}
+
+bool TFManager::lookupTransform(const std::string& target_frame, const std::string& source_frame,
+                               double time, Transform& transform) const {
+    return lookupTransform(findFrameId(target_frame), findFrameId(source_frame), time, transform);
+}
+
+bool TFManager::lookupTransform(FrameId target_frame, FrameId source_frame, double time,
+                               Transform& transform) const {
+    return acquireSnapshot()->lookupTransform(target_frame, source_frame, time, transform);
+}
+
+size_t TFManager::lookupTransforms(const std::string& target_frame, const std::vector<std::string>& source_frames,
+                                  std::vector<Transform>& transforms, std::vector<bool>& found) const {
+    return lookupTransforms(findFrameId(target_frame), findFrameIds(source_frames), transforms, found);
+}
+
+size_t TFManager::lookupTransforms(const std::string& target_frame, const std::vector<std::string>& source_frames,
+                                  double time, std::vector<Transform>& transforms, std::vector<bool>& found) const {
+    return lookupTransforms(findFrameId(target_frame), findFrameIds(source_frames), time, transforms, found);
+}
+
+size_t TFManager::lookupTransforms(FrameId target_frame, const std::vector<FrameId>& source_frames,
+                                  std::vector<Transform>& transforms, std::vector<bool>& found) const {
+    return acquireSnapshot()->lookupTransforms(target_frame, source_frames, transforms, found);
+}
+
+size_t TFManager::lookupTransforms(FrameId target_frame, const std::vector<FrameId>& source_frames,
+                                  double time, std::vector<Transform>& transforms, std::vector<bool>& found) const {
+    return acquireSnapshot()->lookupTransforms(target_frame, source_frames, time, transforms, found);
 }
 
 std::vector<std::string> TFManager::getAllFrameNames() const {
-    std::vector<std::string> names;
-    names.reserve(m_nodes.size());
-    
-    for (const auto& [name, _] : m_nodes) {
-        names.push_back(name);
-    }
-    
-    return names;
+    return acquireSnapshot()->getAllFrameNames();
+}
+
+std::vector<FrameId> TFManager::getAllFrameIds() const {
+    return acquireSnapshot()->getAllFrameIds();
 }
 
 glm::vec3 TFManager::getFramePosition(const std::string& frame) const {
-    Transform worldToFrame;
-    if (lookupTransform("world", frame, worldToFrame)) {
-        // 逆向变换，从frame到world
-        Transform frameToWorld = worldToFrame.inverse();
-        return frameToWorld.translation;
-    }
-    
-    // 如果找不到变换，返回原点
-    return glm::vec3(0.0f, 0.0f, 0.0f);
+    return getFramePosition(findFrameId(frame));
+}
+
+glm::vec3 TFManager::getFramePosition(FrameId frame) const {
+    return acquireSnapshot()->getFramePosition(frame);
 }
 
 void TFManager::getConnectionsForRendering(std::vector<std::pair<glm::vec3, glm::vec3>>& connections) const {
-    connections.clear();
-    
-    // 遍历所有节点
-    for (const auto& [name, node] : m_nodes) {
-        const TransformNode* childNode = node.get();
-        const TransformNode* parentNode = childNode->getParent();
-        
-        if (parentNode) {
-            // 计算子节点和父节点在世界坐标系下的位置
-            glm::vec3 childPos = getFramePosition(childNode->getName());
-            glm::vec3 parentPos = getFramePosition(parentNode->getName());
-            
-            // 添加连接线
-            connections.emplace_back(parentPos, childPos);
-        }
-    }
+    acquireSnapshot()->getConnectionsForRendering(connections);
 }
 
-TransformNode* TFManager::findOrCreateNode(const std::string& name) {
-    auto it = m_nodes.find(name);
-    if (it != m_nodes.end()) {
-        return it->second.get();
-    } else {
+TransformNode* TFManager::findOrCreateNode(FrameId id) {
+    if (id.value >= m_nodes.size()) {
+        m_nodes.resize(m_frameNames.size());
+    }
+    
+    std::unique_ptr<TransformNode>& slot = m_nodes[id.value];
+    if (!slot) {
         // 创建新节点
-        auto [newIt, inserted] = m_nodes.emplace(name, std::make_unique<TransformNode>(name));
-        return newIt->second.get();
+        slot = std::make_unique<TransformNode>(id, m_frameNames.getName(id));
+        slot->getHistory().setLimits(m_bufferDuration, m_bufferMaxSamples);
+        markChanged(id, false);
     }
+    return slot.get();
 }
 
-TransformNode* TFManager::findNode(const std::string& name) const {
-    auto it = m_nodes.find(name);
-    return (it != m_nodes.end()) ? it->second.get() : nullptr;
+void TFManager::markChanged(FrameId id, bool subtree) {
+    m_pendingChanges.emplace_back(id, subtree);
 }
 
-bool TFManager::findTransformPath(const TransformNode* target, const TransformNode* source,
-                                 std::vector<std::pair<const TransformNode*, bool>>& path) const {
-    // 如果源或目标节点有一个不存在，返回失败
-    if (!target || !source) {
-        return false;
+void TFManager::publish() {
+    if (m_pendingChanges.empty()) {
+        return;
     }
     
-    // 特殊情况：源和目标是同一个节点
-    if (target == source) {
-        return true; // 路径为空，单位变换
+    // 从当前快照复制出下一个版本，只复制顶层的块表指针（每个覆盖CHUNK_SIZE * TABLE_SIZE个坐标系），
+    // 块表和块在写入时才复制
+    const TFSnapshot* current = m_current.load();
+    std::unique_ptr<TFSnapshot> next(current ? new TFSnapshot(*current) : new TFSnapshot(&m_frameNames));
+    next->m_version = current ? current->getVersion() + 1 : 1;
+    next->m_world = m_worldFrame;
+    
+    const size_t chunkCount = (m_nodes.size() + TFSnapshot::CHUNK_SIZE - 1) / TFSnapshot::CHUNK_SIZE;
+    const size_t tableCount = (chunkCount + TFSnapshot::TABLE_SIZE - 1) / TFSnapshot::TABLE_SIZE;
+    if (next->m_tables.size() < tableCount) {
+        next->m_tables.resize(tableCount);
+    }
+    if (m_tableVersions.size() < tableCount) {
+        m_tableVersions.resize(tableCount, 0);
     }
+    if (m_chunkVersions.size() < chunkCount) {
+        m_chunkVersions.resize(chunkCount, 0);
+    }
+    if (m_changeMarks.size() < m_nodes.size()) {
+        m_changeMarks.resize(m_nodes.size(), 0);
+    }
+    
+    // 从节点写入权威状态，要求父节点的状态已写入下一个快照
+    auto writeNode = [&](const TransformNode* node) {
+        // 跳跃指针：若父节点与其跳跃目标的深度差等于跳跃目标与再下一跳的深度差，
+        // 则合并为一次更长的跳跃，否则指向父节点；这样任意祖先查询都只需O(log N)步
+        FrameId jump = node->getId();
+        
+        // 静态边链折叠：到父节点的边不随时间变化时，挂到父节点的staticBase上并预先组合变换
+        FrameId staticBase = node->getId();
+        Transform staticOffset;
+        
+        if (const TransformNode* parent = node->getParent()) {
+            const TFFrameState* p = next->getFrame(parent->getId());
+            const TFFrameState* pj = next->getFrame(p->jump);
+            const TFFrameState* pjj = next->getFrame(pj->jump);
+            jump = (p->depth - pj->depth == pj->depth - pjj->depth) ? pj->jump : parent->getId();
+            
+            if (node->getHistory().empty()) {
+                staticBase = p->staticBase;
+                staticOffset = p->staticOffset * node->getTransform();
+            }
+        }
+        
+        TFFrameState& state = writableFrame(*next, node->getId());
+        state.exists = true;
+        state.id = node->getId();
+        state.jump = jump;
+        state.staticBase = staticBase;
+        state.staticOffset = staticOffset;
+        state.parent = node->getParent() ? node->getParent()->getId() : FrameId();
+        state.root = node->getRoot()->getId();
+        state.depth = node->getDepth();
+        state.transform = node->getTransform();
+        state.world = node->getWorldTransform();
+        state.history = node->getHistory();
+        state.version = next->m_version;
+    };
     
-    // 使用广度优先搜索查找最短路径
-    std::queue<const TransformNode*> queue;
-    std::map<const TransformNode*, const TransformNode*> cameFrom;
-    std::map<const TransformNode*, bool> isInverse; // 表示边的方向
+    // 按深度处理，保证写入每个节点时其父节点的状态已是最新
+    std::stable_sort(m_pendingChanges.begin(), m_pendingChanges.end(),
+        [this](const std::pair<FrameId, bool>& a, const std::pair<FrameId, bool>& b) {
+            const TransformNode* nodeA = getNode(a.first);
+            const TransformNode* nodeB = getNode(b.first);
+            return (nodeA ? nodeA->getDepth() + 1 : 0) < (nodeB ? nodeB->getDepth() + 1 : 0);
+        });
     
-    queue.push(source);
-    cameFrom[source] = nullptr;
+    // 同一坐标系可能被记录多次，按标记去重；已更新过子树的坐标系无需再次处理
+    const uint64_t nodeMark = next->m_version * 2;
+    const uint64_t subtreeMark = nodeMark + 1;
+    std::vector<const TransformNode*> stack;
     
-    while (!queue.empty()) {
-        const TransformNode* current = queue.front();
-        queue.pop();
+    for (const auto& [id, subtree] : m_pendingChanges) {
+        uint64_t& mark = m_changeMarks[id.value];
+        if (mark == subtreeMark || (mark == nodeMark && !subtree)) {
+            continue;
+        }
+        mark = subtree ? subtreeMark : nodeMark;
+        
+        const TransformNode* node = getNode(id);
+        if (!node) {
+            // 坐标系已被移除，保留句柄和版本号
+            TFFrameState& removed = writableFrame(*next, id);
+            removed = TFFrameState();
+            removed.id = id;
+            removed.version = next->m_version;
+            continue;
+        }
         
-        // 检查是否找到目标
-        if (current == target) {
-            // 重建路径
-            path.clear();
-            const TransformNode* pathNode = current;
+        writeNode(node);
+        if (!subtree) {
+            continue;
+        }
+        
+        // 子树中所有节点的世界变换都可能改变
+        stack.assign(node->getChildren().begin(), node->getChildren().end());
+        while (!stack.empty()) {
+            const TransformNode* child = stack.back();
+            stack.pop_back();
             
-            while (pathNode != source) {
-                const TransformNode* fromNode = cameFrom[pathNode];
-                bool inverse = isInverse[pathNode];
-                
-                if (inverse) {
-                    // 反向边：fromNode是子节点，pathNode是父节点
-                    path.emplace_back(fromNode, true);
-                } else {
-                    // 正向边：fromNode是父节点，pathNode是子节点
-                    path.emplace_back(pathNode, false);
-                }
-                
-                pathNode = fromNode;
+            uint64_t& childMark = m_changeMarks[child->getId().value];
+            if (childMark == subtreeMark) {
+                continue;
             }
+            childMark = subtreeMark;
             
-            // 反转路径，使其从源到目标
-            std::reverse(path.begin(), path.end());
-            return true;
+            writeNode(child);
+            stack.insert(stack.end(), child->getChildren().begin(), child->getChildren().end());
         }
-        
-        // 向上探索：检查父节点
-        if (current->getParent() && cameFrom.find(current->getParent()) == cameFrom.end()) {
-            queue.push(current->getParent());
-            cameFrom[current->getParent()] = current;
-            isInverse[current->getParent()] = true; // 反向：从子节点到父节点
+    }
+    m_pendingChanges.clear();
+    m_topologyChanged = false;
+    
+    // 发布新快照，被替换的快照记录替换时的纪元后延迟回收
+    const TFSnapshot* previous = m_current.exchange(next.release());
+    const uint64_t epoch = m_epoch.fetch_add(1);
+    if (previous) {
+        m_retired.emplace_back(epoch, previous);
+    }
+    
+    reclaimSnapshots();
+}
+
+TFFrameState& TFManager::writableFrame(TFSnapshot& snapshot, FrameId id) {
+    const size_t index = id.value / TFSnapshot::CHUNK_SIZE;
+    const size_t tableIndex = index / TFSnapshot::TABLE_SIZE;
+    std::shared_ptr<TFSnapshot::ChunkTable>& table = snapshot.m_tables[tableIndex];
+    
+    // 块表和块都可能被旧快照共享，本次发布首次写入时各复制一份
+    if (m_tableVersions[tableIndex] != snapshot.m_version) {
+        table = table ? std::make_shared<TFSnapshot::ChunkTable>(*table) : std::make_shared<TFSnapshot::ChunkTable>();
+        m_tableVersions[tableIndex] = snapshot.m_version;
+    }
+    
+    std::shared_ptr<TFSnapshot::Chunk>& chunk = table->chunks[index % TFSnapshot::TABLE_SIZE];
+    if (m_chunkVersions[index] != snapshot.m_version) {
+        chunk = chunk ? std::make_shared<TFSnapshot::Chunk>(*chunk) : std::make_shared<TFSnapshot::Chunk>();
+        m_chunkVersions[index] = snapshot.m_version;
+    }
+    return chunk->frames[id.value % TFSnapshot::CHUNK_SIZE];
+}
+
+void TFManager::reclaimSnapshots() {
+    // 读者先公布纪元再读取快照指针，因此在纪元r时被替换的快照
+    // 只可能被公布纪元不大于r的读者持有
+    uint64_t oldestEpoch = UINT64_MAX;
+    for (const TFReaderSlot& slot : m_readerSlots) {
+        if (slot.active.load()) {
+            oldestEpoch = std::min(oldestEpoch, slot.epoch.load());
         }
-        
-        // 向下探索：检查子节点
-        for (const TransformNode* child : current->getChildren()) {
-            if (cameFrom.find(child) == cameFrom.end()) {
-                queue.push(child);
-                cameFrom[child] = current;
-                isInverse[child] = false; // 正向：从父节点到子节点
+    }
+    
+    auto it = std::remove_if(m_retired.begin(), m_retired.end(),
+        [oldestEpoch](const std::pair<uint64_t, const TFSnapshot*>& retired) {
+            if (retired.first < oldestEpoch) {
+                delete retired.second;
+                return true;
             }
+            return false;
+        });
+    m_retired.erase(it, m_retired.end());
+}
+
+std::vector<FrameId> TFManager::findFrameIds(const std::vector<std::string>& frames) const {
+    std::vector<FrameId> ids;
+    ids.reserve(frames.size());
+    for (const auto& frame : frames) {
+        ids.push_back(findFrameId(frame));
+    }
+    return ids;
+}
+
+bool TFManager::wouldCreateCycle(const TransformNode* parent, const TransformNode* child) const {
+    // 只有child是parent本身或其祖先时才会形成环；没有子节点的坐标系（包括新建的坐标系）不可能是其他坐标系的祖先
+    if (parent == child) {
+        return true;
+    }
+    if (child->getChildren().empty()) {
+        return false;
+    }
+    
+    // 自上次发布以来父子关系没有改变时，用快照的跳跃指针在O(log N)内判断child是否为parent的祖先；
+    // 快照中没有的坐标系是本次发布前新建的，此时尚无父节点
+    const TFSnapshot* snapshot = m_current.load();
+    if (!m_topologyChanged && snapshot) {
+        const TFFrameState* parentState = snapshot->getFrame(parent->getId());
+        const TFFrameState* childState = snapshot->getFrame(child->getId());
+        if (!parentState || !childState || childState->depth > parentState->depth) {
+            return false;
         }
+        return snapshot->getAncestorAtDepth(parent->getId(), childState->depth) == child->getId();
     }
     
-    // 如果遍历完整个图仍未找到目标，返回失败
+    // 同一批更新中已有父子关系改变，快照已过时，沿父节点链向上查找
+    for (const TransformNode* node = parent; node; node = node->getParent()) {
+        if (node == child) {
+            return true;
+        }
+    }
     return false;
 }
 
@@ -0,0 +1,326 @@
+#include "core/TFSnapshot.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace mviz {
+
+//-------------------- TFFrameState 实现 --------------------
+
+bool TFFrameState::getTransformAt(double stamp, Transform& result) const {
+    if (history.empty()) {
+        result = transform;
+        return true;
+    }
+    return history.lookup(stamp, result);
+}
+
+//-------------------- TFSnapshot 实现 --------------------
+
+const TFSnapshot::Chunk* TFSnapshot::getChunk(size_t index) const {
+    const size_t table = index / TABLE_SIZE;
+    if (table >= m_tables.size() || !m_tables[table]) {
+        return nullptr;
+    }
+    return m_tables[table]->chunks[index % TABLE_SIZE].get();
+}
+
+const TFFrameState* TFSnapshot::getFrame(FrameId frame) const {
+    const Chunk* chunk = frame.isValid() ? getChunk(frame.value / CHUNK_SIZE) : nullptr;
+    if (!chunk) {
+        return nullptr;
+    }
+    
+    const TFFrameState& state = chunk->frames[frame.value % CHUNK_SIZE];
+    return state.exists ? &state : nullptr;
+}
+
+uint64_t TFSnapshot::getFrameVersion(FrameId frame) const {
+    const Chunk* chunk = frame.isValid() ? getChunk(frame.value / CHUNK_SIZE) : nullptr;
+    if (!chunk) {
+        return 0;
+    }
+    
+    // 已移除的坐标系同样保留版本号，以便读者察觉其消失
+    return chunk->frames[frame.value % CHUNK_SIZE].version;
+}
+
+FrameId TFSnapshot::getAncestorAtDepth(FrameId frame, uint32_t depth) const {
+    const TFFrameState* state = getFrame(frame);
+    if (!state || depth > state->depth) {
+        return FrameId();
+    }
+    
+    return climbToDepth(state, depth)->id;
+}
+
+FrameId TFSnapshot::findCommonAncestor(FrameId frame_a, FrameId frame_b) const {
+    const TFFrameState* a = getFrame(frame_a);
+    const TFFrameState* b = getFrame(frame_b);
+    if (!a || !b || a->root != b->root) {
+        return FrameId();
+    }
+    
+    // 先把较深的一方提升到相同深度
+    if (a->depth > b->depth) {
+        a = climbToDepth(a, b->depth);
+    } else if (b->depth > a->depth) {
+        b = climbToDepth(b, a->depth);
+    }
+    
+    // 深度相同的节点其跳跃指针的深度也相同：跳跃后仍不相遇就跳，否则只走一步
+    while (a != b) {
+        if (a->jump != b->jump) {
+            a = getFrame(a->jump);
+            b = getFrame(b->jump);
+        } else {
+            a = getFrame(a->parent);
+            b = getFrame(b->parent);
+        }
+    }
+    return a->id;
+}
+
+const TFFrameState* TFSnapshot::climbToDepth(const TFFrameState* frame, uint32_t depth) const {
+    while (frame->depth > depth) {
+        const TFFrameState* jump = getFrame(frame->jump);
+        frame = (jump->depth >= depth) ? jump : getFrame(frame->parent);
+    }
+    return frame;
+}
+
+bool TFSnapshot::accumulateToAncestor(const TFFrameState* frame, const TFFrameState* ancestor, double time,
+                                      Transform& result) const {
+    result = Transform();
+    Transform edge;
+    while (frame != ancestor) {
+        const TFFrameState* base = getFrame(frame->staticBase);
+        
+        // 剩余路径全部是静态边：ancestor位于base和frame之间，两者的staticBase相同
+        if (base->depth <= ancestor->depth) {
+            result = ancestor->staticOffset.inverse() * frame->staticOffset * result;
+            return true;
+        }
+        
+        // 跳过静态边到达base，再对base到其父节点的边插值
+        if (!base->getTransformAt(time, edge)) {
+            return false;
+        }
+        result = edge * frame->staticOffset * result;
+        frame = getFrame(base->parent);
+    }
+    return true;
+}
+
+bool TFSnapshot::lookupTransform(FrameId target_frame, FrameId source_frame, Transform& transform) const {
+    const TFFrameState* source = getFrame(source_frame);
+    const TFFrameState* target = getFrame(target_frame);
+    
+    // 两个坐标系都必须存在且位于同一棵树中
+    if (!source || !target || source->root != target->root) {
+        return false;
+    }
+    
+    if (source == target) {
+        transform = Transform(); // 单位变换
+        return true;
+    }
+    
+    // inverse(W_target) * W_source
+    transform = target->world.inverse() * source->world;
+    return true;
+}
+
+bool TFSnapshot::lookupTransform(FrameId target_frame, FrameId source_frame, double time,
+                                 Transform& transform) const {
+    // 未指定时刻时使用最新变换
+    if (time <= 0.0) {
+        return lookupTransform(target_frame, source_frame, transform);
+    }
+    
+    const TFFrameState* source = getFrame(source_frame);
+    const TFFrameState* target = getFrame(target_frame);
+    
+    if (!source || !target || source->root != target->root) {
+        return false;
+    }
+    
+    // 先用跳跃指针定位最近公共祖先，再分别从源和目标向上走到它，累积指定时刻的变换
+    const TFFrameState* ancestor = getFrame(findCommonAncestor(target_frame, source_frame));
+    Transform ancestorToSource;
+    Transform ancestorToTarget;
+    if (!accumulateToAncestor(source, ancestor, time, ancestorToSource) ||
+        !accumulateToAncestor(target, ancestor, time, ancestorToTarget)) {
+        return false;
+    }
+    
+    transform = ancestorToTarget.inverse() * ancestorToSource;
+    return true;
+}
+
+size_t TFSnapshot::lookupTransforms(FrameId target_frame, const std::vector<FrameId>& source_frames,
+                                    std::vector<Transform>& transforms, std::vector<bool>& found) const {
+    transforms.assign(source_frames.size(), Transform());
+    found.assign(source_frames.size(), false);
+    
+    const TFFrameState* target = getFrame(target_frame);
+    if (!target) {
+        return 0;
+    }
+    
+    // 目标坐标系只解析一次
+    const Transform targetInverse = target->world.inverse();
+    
+    size_t count = 0;
+    for (size_t i = 0; i < source_frames.size(); ++i) {
+        const TFFrameState* source = getFrame(source_frames[i]);
+        if (!source || source->root != target->root) {
+            continue;
+        }
+        
+        transforms[i] = (source == target) ? Transform() : targetInverse * source->world;
+        found[i] = true;
+        ++count;
+    }
+    
+    return count;
+}
+
+size_t TFSnapshot::lookupTransforms(FrameId target_frame, const std::vector<FrameId>& source_frames,
+                                    double time, std::vector<Transform>& transforms, std::vector<bool>& found) const {
+    // 未指定时刻时使用最新的变换
+    if (time <= 0.0) {
+        return lookupTransforms(target_frame, source_frames, transforms, found);
+    }
+    
+    transforms.assign(source_frames.size(), Transform());
+    found.assign(source_frames.size(), false);
+    
+    const TFFrameState* target = getFrame(target_frame);
+    if (!target) {
+        return 0;
+    }
+    
+    // 本次查找中已求得的“根节点到该坐标系”在指定时刻的变换，无法求得的坐标系记为false
+    // 只记录各条动态边的子端（staticBase），其余坐标系通过预先组合的静态变换求得
+    std::unordered_map<const TFFrameState*, std::pair<bool, Transform>> resolved;
+    
+    // 自下而上沿staticBase走到第一个已求得的动态边（或根节点），再自上而下依次填充
+    std::vector<const TFFrameState*> chain;
+    auto resolve = [&](const TFFrameState* frame) -> std::pair<bool, Transform> {
+        chain.clear();
+        std::pair<bool, Transform> state(true, Transform());
+        const TFFrameState* base = getFrame(frame->staticBase);
+        for (;;) {
+            auto it = resolved.find(base);
+            if (it != resolved.end()) {
+                state = it->second;
+                break;
+            }
+            chain.push_back(base);
+            if (!base->parent.isValid()) {
+                break;
+            }
+            base = getFrame(getFrame(base->parent)->staticBase);
+        }
+        
+        // 此时state为根节点到chain末尾元素父节点所在staticBase的变换
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            const TFFrameState* step = *it;
+            Transform edge;
+            if (!step->parent.isValid()) {
+                state = {true, Transform()}; // 根节点
+            } else if (state.first && step->getTransformAt(time, edge)) {
+                state.second = state.second * getFrame(step->parent)->staticOffset * edge;
+            } else {
+                state.first = false;
+            }
+            resolved.emplace(step, state);
+        }
+        
+        std::pair<bool, Transform> result = resolved[getFrame(frame->staticBase)];
+        result.second = result.second * frame->staticOffset;
+        return result;
+    };
+    
+    const auto targetState = resolve(target);
+    const Transform targetInverse = targetState.second.inverse();
+    
+    size_t count = 0;
+    for (size_t i = 0; i < source_frames.size(); ++i) {
+        const TFFrameState* source = getFrame(source_frames[i]);
+        if (!source || source->root != target->root) {
+            continue;
+        }
+        
+        const auto sourceState = resolve(source);
+        if (targetState.first && sourceState.first) {
+            transforms[i] = targetInverse * sourceState.second;
+        } else if (!lookupTransform(target_frame, source_frames[i], time, transforms[i])) {
+            // 根节点路径上有边无法覆盖该时刻时，两者之间的路径仍可能不经过这些边
+            continue;
+        }
+        
+        found[i] = true;
+        ++count;
+    }
+    
+    return count;
+}
+
+glm::vec3 TFSnapshot::getFramePosition(FrameId frame) const {
+    const TFFrameState* state = getFrame(frame);
+    const TFFrameState* world = getFrame(m_world);
+    
+    // 如果坐标系不存在或与世界坐标系不连通，返回原点
+    if (!state || !world || state->root != world->root) {
+        return glm::vec3(0.0f, 0.0f, 0.0f);
+    }
+    
+    // 世界坐标系通常就是根节点，此时其变换为单位变换
+    if (!world->parent.isValid()) {
+        return state->world.translation;
+    }
+    return (world->world.inverse() * state->world).translation;
+}
+
+std::vector<FrameId> TFSnapshot::getAllFrameIds() const {
+    std::vector<FrameId> ids;
+    
+    for (size_t index = 0; index < m_tables.size() * TABLE_SIZE; ++index) {
+        const Chunk* chunk = getChunk(index);
+        if (!chunk) continue;
+        
+        for (size_t i = 0; i < CHUNK_SIZE; ++i) {
+            if (chunk->frames[i].exists) {
+                ids.emplace_back(static_cast<uint32_t>(index * CHUNK_SIZE + i));
+            }
+        }
+    }
+    
+    return ids;
+}
+
+std::vector<std::string> TFSnapshot::getAllFrameNames() const {
+    std::vector<std::string> names;
+    for (FrameId id : getAllFrameIds()) {
+        names.push_back(getFrameName(id));
+    }
+    
+    // 保持按名称排序，便于界面显示
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+void TFSnapshot::getConnectionsForRendering(std::vector<std::pair<glm::vec3, glm::vec3>>& connections) const {
+    connections.clear();
+    
+    for (FrameId id : getAllFrameIds()) {
+        const TFFrameState* child = getFrame(id);
+        if (child->parent.isValid()) {
+            // 添加父坐标系到子坐标系的连接线
+            connections.emplace_back(getFramePosition(child->parent), getFramePosition(id));
+        }
+    }
+}
+
+} // namespace mviz 
\ No newline at end of file
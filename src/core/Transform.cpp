@@ -0,0 +1,213 @@
+#include "core/Transform.h"
+#include <algorithm>
+#include <mutex>
+
+namespace mviz {
+
+//-------------------- Transform 实现 --------------------
+
+glm::mat4 Transform::toMat4() const {
+    // 创建从旋转四元数得到的旋转矩阵
+    glm::mat4 rotMat = glm::mat4_cast(rotation);
+    
+    // 设置平移部分
+    rotMat[3][0] = translation.x;
+    rotMat[3][1] = translation.y;
+    rotMat[3][2] = translation.z;
+    
+    return rotMat;
+}
+
+Transform Transform::operator*(const Transform& other) const {
+    // 组合变换
+    Transform result;
+    result.rotation = rotation * other.rotation;
+    result.translation = translation + rotation * other.translation;
+    return result;
+}
+
+Transform Transform::inverse() const {
+    // 反转变换
+    Transform result;
+    result.rotation = glm::inverse(rotation);
+    result.translation = -(result.rotation * translation);
+    return result;
+}
+
+Transform Transform::interpolate(const Transform& from, const Transform& to, float ratio) {
+    Transform result;
+    result.translation = glm::mix(from.translation, to.translation, ratio);
+    result.rotation = glm::slerp(from.rotation, to.rotation, ratio);
+    return result;
+}
+
+//-------------------- TransformBuffer 实现 --------------------
+
+namespace {
+// 存储块的最小容量
+constexpr size_t MIN_BLOCK_CAPACITY = 16;
+}
+
+TransformBuffer::TransformBuffer()
+    : m_begin(0)
+    , m_count(0)
+    , m_maxDuration(DEFAULT_MAX_DURATION)
+    , m_maxSamples(DEFAULT_MAX_SAMPLES)
+{
+}
+
+void TransformBuffer::setLimits(double max_duration, size_t max_samples) {
+    m_maxDuration = max_duration;
+    m_maxSamples = std::max<size_t>(max_samples, 1);
+    evict();
+}
+
+void TransformBuffer::insert(double stamp, const Transform& transform) {
+    const Sample sample{stamp, transform};
+    
+    // 最常见的情况：按时间顺序追加
+    if (m_count == 0 || stamp > newest().stamp) {
+        // 只有当本缓冲区的末尾就是存储块的末尾时才能原地追加，
+        // 否则存储块已满或被其他拷贝继续追加过，需要复制到新的存储块
+        if (m_block && m_begin + m_count == m_block->used && m_block->used < m_block->samples.size()) {
+            m_block->samples[m_block->used++] = sample;
+            ++m_count;
+        } else {
+            rebuild(m_count, sample);
+        }
+        evict();
+        return;
+    }
+    
+    // 乱序样本：查找插入位置，已写入的样本不能原地修改，因此复制到新的存储块
+    size_t pos = lowerBound(stamp);
+    
+    // 比最旧样本还旧且缓冲区已满，直接丢弃
+    if (pos == 0 && at(0).stamp != stamp && m_count >= m_maxSamples) {
+        return;
+    }
+    
+    rebuild(pos, sample);
+    evict();
+}
+
+bool TransformBuffer::lookup(double stamp, Transform& transform) const {
+    if (m_count == 0) {
+        return false;
+    }
+    
+    // 只有一个样本时视为不随时间变化
+    if (m_count == 1) {
+        transform = at(0).transform;
+        return true;
+    }
+    
+    // 超出缓冲区时间范围，不做外推
+    if (stamp < oldest().stamp || stamp > newest().stamp) {
+        return false;
+    }
+    
+    size_t upper = lowerBound(stamp);
+    const Sample& next = at(upper);
+    if (next.stamp == stamp || upper == 0) {
+        transform = next.transform;
+        return true;
+    }
+    
+    // 在相邻两个样本之间插值
+    const Sample& prev = at(upper - 1);
+    float ratio = static_cast<float>((stamp - prev.stamp) / (next.stamp - prev.stamp));
+    transform = Transform::interpolate(prev.transform, next.transform, ratio);
+    return true;
+}
+
+void TransformBuffer::clear() {
+    m_block.reset();
+    m_begin = 0;
+    m_count = 0;
+}
+
+size_t TransformBuffer::lowerBound(double stamp) const {
+    const Sample* first = m_block->samples.data() + m_begin;
+    const Sample* last = first + m_count;
+    const Sample* it = std::lower_bound(first, last, stamp,
+        [](const Sample& sample, double value) { return sample.stamp < value; });
+    return static_cast<size_t>(it - first);
+}
+
+void TransformBuffer::rebuild(size_t position, const Sample& sample) {
+    // 时间戳相同的样本被覆盖
+    const bool replace = position < m_count && at(position).stamp == sample.stamp;
+    const size_t count = replace ? m_count : m_count + 1;
+    
+    // 预留一倍的空间用于后续追加，使复制的开销均摊为常数
+    auto block = std::make_shared<Block>();
+    block->samples.resize(std::max(count * 2, MIN_BLOCK_CAPACITY));
+    
+    Sample* out = block->samples.data();
+    if (m_count > 0) {
+        const Sample* in = m_block->samples.data() + m_begin;
+        out = std::copy(in, in + position, out);
+        *out++ = sample;
+        out = std::copy(in + position + (replace ? 1 : 0), in + m_count, out);
+    } else {
+        *out++ = sample;
+    }
+    
+    block->used = count;
+    m_block = std::move(block);
+    m_begin = 0;
+    m_count = count;
+}
+
+void TransformBuffer::evict() {
+    // 超出样本数上限时丢弃最旧的样本
+    if (m_count > m_maxSamples) {
+        m_begin += m_count - m_maxSamples;
+        m_count = m_maxSamples;
+    }
+    
+    // 按时长淘汰，至少保留一个样本
+    while (m_count > 1 && newest().stamp - oldest().stamp > m_maxDuration) {
+        ++m_begin;
+        --m_count;
+    }
+}
+
+//-------------------- FrameNameTable 实现 --------------------
+
+FrameId FrameNameTable::intern(const std::string& name) {
+    // 大多数情况下名称已经存在，只需共享锁
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_ids.find(name);
+        if (it != m_ids.end()) {
+            return it->second;
+        }
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto [it, inserted] = m_ids.emplace(name, FrameId(static_cast<uint32_t>(m_names.size())));
+    if (inserted) {
+        m_names.push_back(&it->first);
+    }
+    return it->second;
+}
+
+FrameId FrameNameTable::find(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_ids.find(name);
+    return (it != m_ids.end()) ? it->second : FrameId();
+}
+
+const std::string& FrameNameTable::getName(FrameId id) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return *m_names[id.value];
+}
+
+size_t FrameNameTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_names.size();
+}
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,510 @@
+#include "data/OctreeBuilder.h"
+#include "data/OctreeFile.h"
+#include "visualization/PointPacking.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+namespace mviz {
+
+namespace {
+
+// 每次从输入读取的点数
+constexpr size_t READ_BATCH_POINTS = 1 << 20;
+
+// 分区中缓存的点数达到此值时写入分区文件
+constexpr size_t BUCKET_FLUSH_POINTS = 1 << 16;
+
+// 外存分区的最大层数（最多8^3个分区文件）
+constexpr uint32_t MAX_BUCKET_LEVEL = 3;
+
+// 分区文件中的点
+struct BucketPoint {
+    float x, y, z;
+    uint32_t color;
+};
+
+// 采样网格：记录节点立方体的每个单元是否已有点
+class SampleGrid {
+public:
+    explicit SampleGrid(uint32_t size)
+        : m_bits((static_cast<size_t>(size) * size * size + 63) / 64, 0)
+    {
+    }
+    
+    // 单元为空时占用它并返回true
+    bool insert(size_t cell) {
+        uint64_t& word = m_bits[cell / 64];
+        const uint64_t mask = uint64_t(1) << (cell % 64);
+        if (word & mask) {
+            return false;
+        }
+        word |= mask;
+        return true;
+    }
+    
+    void clear() {
+        std::fill(m_bits.begin(), m_bits.end(), 0);
+    }
+    
+private:
+    std::vector<uint64_t> m_bits;
+};
+
+// 构建中的节点
+struct BuildNode {
+    glm::vec3 min{0.0f};
+    float size = 0.0f;
+    uint32_t level = 0;
+    std::unique_ptr<BuildNode> children[8];
+    
+    // 节点保存的点，写入输出文件后释放
+    std::vector<glm::vec3> points;
+    std::vector<uint32_t> colors;
+    uint64_t dataOffset = 0;
+    uint32_t pointCount = 0;
+    
+    // 前bucketLevel层节点在分区阶段使用的采样网格
+    std::unique_ptr<SampleGrid> grid;
+    
+    // 第bucketLevel层节点（分区）：尚未写入分区文件的点和分区文件
+    bool isBucket = false;
+    std::vector<BucketPoint> pending;
+    std::string bucketPath;
+};
+
+class OctreeBuilder {
+public:
+    OctreeBuilder(OctreePointSource& source, const OctreeBuildOptions& options, OctreeBuildStats& stats)
+        : m_source(source)
+        , m_options(options)
+        , m_stats(stats)
+        , m_hasColors(source.hasColors())
+        , m_gridSize(std::clamp<uint32_t>(options.gridSize, 4, 256))
+        , m_grid(m_gridSize)
+        , m_offset(0)
+    {
+        m_stats = OctreeBuildStats();
+    }
+    
+    bool build(const std::string& outputPath) {
+        if (!computeBounds()) {
+            return false;
+        }
+        
+        m_tempDirectory = m_options.tempDirectory.empty() ? outputPath + ".tmp" : m_options.tempDirectory;
+        std::error_code error;
+        if (m_stats.bucketLevel > 0 && !std::filesystem::create_directories(m_tempDirectory, error) && error) {
+            std::cerr << "Failed to create temporary directory: " << m_tempDirectory << std::endl;
+            return false;
+        }
+        
+        m_output.open(outputPath, std::ios::binary | std::ios::trunc);
+        if (!m_output) {
+            std::cerr << "Failed to create octree file: " << outputPath << std::endl;
+            return false;
+        }
+        
+        // 文件头在最后写入，先留出位置
+        OctreeFileHeader header{};
+        m_output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_offset = sizeof(header);
+        
+        const bool succeeded = partition() && buildBuckets() && writeUpperNodes() && writeNodeTable();
+        m_output.close();
+        
+        if (m_stats.bucketLevel > 0) {
+            std::filesystem::remove_all(m_tempDirectory, error);
+        }
+        if (!succeeded || !m_output) {
+            std::cerr << "Failed to write octree file: " << outputPath << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
+private:
+    // 第一遍：求包围盒和点数，确定根节点立方体和分区层数
+    bool computeBounds() {
+        if (!m_source.rewind()) {
+            std::cerr << "Failed to read point source" << std::endl;
+            return false;
+        }
+        
+        glm::vec3 min(std::numeric_limits<float>::max());
+        glm::vec3 max(std::numeric_limits<float>::lowest());
+        uint64_t count = 0;
+        std::vector<glm::vec3> points, colors;
+        while (readBatch(points, colors) > 0) {
+            for (const glm::vec3& point : points) {
+                min = glm::min(min, point);
+                max = glm::max(max, point);
+            }
+            count += points.size();
+        }
+        
+        if (count == 0) {
+            std::cerr << "Point source is empty" << std::endl;
+            return false;
+        }
+        
+        m_root = std::make_unique<BuildNode>();
+        m_root->min = min;
+        const glm::vec3 extent = max - min;
+        m_root->size = std::max(std::max(extent.x, extent.y), extent.z);
+        if (!(m_root->size > 0.0f)) {
+            m_root->size = 1.0f;
+        }
+        
+        m_stats.inputPoints = count;
+        const uint64_t bucketPoints = std::max<uint64_t>(m_options.maxBucketPoints, m_options.maxLeafPoints);
+        while (m_stats.bucketLevel < MAX_BUCKET_LEVEL && count > bucketPoints) {
+            ++m_stats.bucketLevel;
+            count /= 8;
+        }
+        return true;
+    }
+    
+    // 读取一批有限坐标的点，颜色与点一一对应
+    size_t readBatch(std::vector<glm::vec3>& points, std::vector<glm::vec3>& colors) {
+        points.clear();
+        colors.clear();
+        const size_t count = m_source.read(points, colors, READ_BATCH_POINTS);
+        points.resize(count);
+        if (m_hasColors) {
+            colors.resize(count, glm::vec3(1.0f));
+        }
+        
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (std::isfinite(points[i].x) && std::isfinite(points[i].y) && std::isfinite(points[i].z)) {
+                points[kept] = points[i];
+                if (m_hasColors) {
+                    colors[kept] = colors[i];
+                }
+                ++kept;
+            }
+        }
+        points.resize(kept);
+        colors.resize(m_hasColors ? kept : 0);
+        return count;
+    }
+    
+    // 第二遍：前bucketLevel层自顶向下采样，其余的点写入所在的分区
+    bool partition() {
+        if (!m_source.rewind()) {
+            std::cerr << "Failed to read point source" << std::endl;
+            return false;
+        }
+        
+        std::vector<glm::vec3> points, colors;
+        std::vector<uint32_t> packed;
+        while (readBatch(points, colors) > 0) {
+            packed.assign(points.size(), 0xFFFFFFFFu);
+            if (m_hasColors) {
+                packColorsRGBA8(colors.data(), colors.size(), packed.data());
+            }
+            
+            for (size_t i = 0; i < points.size(); ++i) {
+                const glm::vec3& point = points[i];
+                BuildNode* node = m_root.get();
+                bool accepted = false;
+                while (node->level < m_stats.bucketLevel) {
+                    if (!node->grid) {
+                        node->grid = std::make_unique<SampleGrid>(m_gridSize);
+                    }
+                    if (node->grid->insert(cellOf(*node, point))) {
+                        node->points.push_back(point);
+                        node->colors.push_back(packed[i]);
+                        accepted = true;
+                        break;
+                    }
+                    node = &child(*node, octantOf(*node, point));
+                }
+                
+                if (!accepted) {
+                    addToBucket(*node, BucketPoint{point.x, point.y, point.z, packed[i]});
+                    if (!m_output) {
+                        return false;
+                    }
+                }
+            }
+        }
+        
+        // 采样网格只在分区阶段使用
+        for (BuildNode* bucket : m_buckets) {
+            if (!flushBucket(*bucket)) {
+                return false;
+            }
+        }
+        releaseGrids(*m_root);
+        return true;
+    }
+    
+    void addToBucket(BuildNode& node, const BucketPoint& point) {
+        if (!node.isBucket) {
+            node.isBucket = true;
+            node.bucketPath = (std::filesystem::path(m_tempDirectory) / ("bucket_" + std::to_string(m_buckets.size()) + ".bin")).string();
+            m_buckets.push_back(&node);
+        }
+        
+        // 只有一个分区时所有点都留在内存中
+        node.pending.push_back(point);
+        if (m_stats.bucketLevel > 0 && node.pending.size() >= BUCKET_FLUSH_POINTS && !flushBucket(node)) {
+            m_output.setstate(std::ios::failbit);
+        }
+    }
+    
+    bool flushBucket(BuildNode& node) {
+        if (m_stats.bucketLevel == 0 || node.pending.empty()) {
+            return true;
+        }
+        
+        // 分区文件很多，不同时保持打开
+        std::ofstream file(node.bucketPath, std::ios::binary | std::ios::app);
+        file.write(reinterpret_cast<const char*>(node.pending.data()), node.pending.size() * sizeof(BucketPoint));
+        node.pending.clear();
+        if (!file) {
+            std::cerr << "Failed to write temporary file: " << node.bucketPath << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
+    void releaseGrids(BuildNode& node) {
+        node.grid.reset();
+        for (auto& child : node.children) {
+            if (child) {
+                releaseGrids(*child);
+            }
+        }
+    }
+    
+    // 逐个载入分区，在内存中采样和细分
+    bool buildBuckets() {
+        for (BuildNode* bucket : m_buckets) {
+            std::vector<BucketPoint> loaded = std::move(bucket->pending);
+            if (m_stats.bucketLevel > 0) {
+                std::ifstream file(bucket->bucketPath, std::ios::binary | std::ios::ate);
+                const size_t count = file ? static_cast<size_t>(file.tellg()) / sizeof(BucketPoint) : 0;
+                loaded.resize(count);
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(loaded.data()), count * sizeof(BucketPoint));
+                if (!file) {
+                    std::cerr << "Failed to read temporary file: " << bucket->bucketPath << std::endl;
+                    return false;
+                }
+                file.close();
+                std::filesystem::remove(bucket->bucketPath);
+            }
+            
+            std::vector<glm::vec3> points(loaded.size());
+            std::vector<uint32_t> colors(loaded.size());
+            for (size_t i = 0; i < loaded.size(); ++i) {
+                points[i] = glm::vec3(loaded[i].x, loaded[i].y, loaded[i].z);
+                colors[i] = loaded[i].color;
+            }
+            std::vector<BucketPoint>().swap(loaded);
+            
+            subdivide(*bucket, points, colors);
+            if (!m_output) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // 采样节点自己保存的点，其余的点按八分体交给子节点递归处理
+    void subdivide(BuildNode& node, std::vector<glm::vec3>& points, std::vector<uint32_t>& colors) {
+        if (points.size() <= m_options.maxLeafPoints || node.level >= m_options.maxDepth) {
+            node.points = std::move(points);
+            node.colors = std::move(colors);
+            writeNode(node);
+            return;
+        }
+        
+        std::vector<glm::vec3> childPoints[8];
+        std::vector<uint32_t> childColors[8];
+        m_grid.clear();
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (m_grid.insert(cellOf(node, points[i]))) {
+                node.points.push_back(points[i]);
+                node.colors.push_back(colors[i]);
+            } else {
+                const int octant = octantOf(node, points[i]);
+                childPoints[octant].push_back(points[i]);
+                childColors[octant].push_back(colors[i]);
+            }
+        }
+        std::vector<glm::vec3>().swap(points);
+        std::vector<uint32_t>().swap(colors);
+        writeNode(node);
+        
+        for (int octant = 0; octant < 8; ++octant) {
+            if (!childPoints[octant].empty()) {
+                subdivide(child(node, octant), childPoints[octant], childColors[octant]);
+            }
+        }
+    }
+    
+    // 写入分区层之上的节点
+    bool writeUpperNodes() {
+        std::vector<BuildNode*> stack{m_root.get()};
+        while (!stack.empty()) {
+            BuildNode* node = stack.back();
+            stack.pop_back();
+            if (node->level >= m_stats.bucketLevel) {
+                continue;
+            }
+            writeNode(*node);
+            for (auto& child : node->children) {
+                if (child) {
+                    stack.push_back(child.get());
+                }
+            }
+        }
+        return static_cast<bool>(m_output);
+    }
+    
+    // 量化节点的点并追加到输出文件，然后释放
+    void writeNode(BuildNode& node) {
+        const size_t count = node.points.size();
+        glm::vec3 scale, offset;
+        computeQuantization(node.min, node.min + glm::vec3(node.size), scale, offset);
+        std::vector<int16_t> quantized(4 * count);
+        quantizePositions(node.points.data(), count, scale, offset, quantized.data());
+        
+        node.dataOffset = m_offset;
+        node.pointCount = static_cast<uint32_t>(count);
+        m_output.write(reinterpret_cast<const char*>(quantized.data()), quantized.size() * sizeof(int16_t));
+        if (m_hasColors) {
+            m_output.write(reinterpret_cast<const char*>(node.colors.data()), count * sizeof(uint32_t));
+        }
+        m_offset += octreeNodeBytes(node.pointCount, m_hasColors);
+        m_stats.outputPoints += count;
+        m_stats.depth = std::max(m_stats.depth, node.level);
+        
+        std::vector<glm::vec3>().swap(node.points);
+        std::vector<uint32_t>().swap(node.colors);
+    }
+    
+    // 按广度优先顺序写入节点表（父节点在子节点之前），最后写入文件头
+    bool writeNodeTable() {
+        std::vector<BuildNode*> order{m_root.get()};
+        for (size_t i = 0; i < order.size(); ++i) {
+            for (auto& child : order[i]->children) {
+                if (child) {
+                    order.push_back(child.get());
+                }
+            }
+        }
+        
+        const uint64_t padding = (alignof(OctreeNodeRecord) - m_offset % alignof(OctreeNodeRecord)) % alignof(OctreeNodeRecord);
+        const char zeros[alignof(OctreeNodeRecord)] = {};
+        m_output.write(zeros, padding);
+        const uint64_t tableOffset = m_offset + padding;
+        
+        size_t nextIndex = 1;
+        for (BuildNode* node : order) {
+            OctreeNodeRecord record{};
+            record.dataOffset = node->dataOffset;
+            record.pointCount = node->pointCount;
+            record.level = static_cast<uint8_t>(node->level);
+            for (int octant = 0; octant < 8; ++octant) {
+                record.children[octant] = -1;
+                if (node->children[octant]) {
+                    record.children[octant] = static_cast<int32_t>(nextIndex++);
+                    record.childMask |= static_cast<uint8_t>(1 << octant);
+                }
+            }
+            record.min[0] = node->min.x;
+            record.min[1] = node->min.y;
+            record.min[2] = node->min.z;
+            record.size = node->size;
+            m_output.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        
+        OctreeFileHeader header{};
+        std::memcpy(header.magic, OCTREE_FILE_MAGIC, sizeof(header.magic));
+        header.version = OCTREE_FILE_VERSION;
+        header.nodeCount = static_cast<uint32_t>(order.size());
+        header.pointCount = m_stats.outputPoints;
+        header.nodeTableOffset = tableOffset;
+        header.min[0] = m_root->min.x;
+        header.min[1] = m_root->min.y;
+        header.min[2] = m_root->min.z;
+        header.size = m_root->size;
+        header.spacing = m_root->size / m_gridSize;
+        header.hasColors = m_hasColors ? 1 : 0;
+        m_output.seekp(0);
+        m_output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        
+        m_stats.nodeCount = header.nodeCount;
+        return static_cast<bool>(m_output);
+    }
+    
+    // 点所在的采样网格单元
+    size_t cellOf(const BuildNode& node, const glm::vec3& point) const {
+        const float scale = m_gridSize / node.size;
+        size_t cell = 0;
+        for (int axis = 2; axis >= 0; --axis) {
+            const float value = (point[axis] - node.min[axis]) * scale;
+            const uint32_t index = value > 0.0f ? std::min(static_cast<uint32_t>(value), m_gridSize - 1) : 0;
+            cell = cell * m_gridSize + index;
+        }
+        return cell;
+    }
+    
+    // 点所在的八分体
+    static int octantOf(const BuildNode& node, const glm::vec3& point) {
+        const glm::vec3 center = node.min + glm::vec3(node.size * 0.5f);
+        return (point.x >= center.x ? 1 : 0) | (point.y >= center.y ? 2 : 0) | (point.z >= center.z ? 4 : 0);
+    }
+    
+    // 获取子节点，不存在时创建
+    static BuildNode& child(BuildNode& node, int octant) {
+        std::unique_ptr<BuildNode>& child = node.children[octant];
+        if (!child) {
+            const float half = node.size * 0.5f;
+            child = std::make_unique<BuildNode>();
+            child->min = node.min + glm::vec3((octant & 1) ? half : 0.0f, (octant & 2) ? half : 0.0f,
+                                              (octant & 4) ? half : 0.0f);
+            child->size = half;
+            child->level = node.level + 1;
+        }
+        return *child;
+    }
+    
+    OctreePointSource& m_source;
+    const OctreeBuildOptions& m_options;
+    OctreeBuildStats& m_stats;
+    bool m_hasColors;
+    uint32_t m_gridSize;
+    
+    // 内存中细分时复用的采样网格
+    SampleGrid m_grid;
+    
+    std::unique_ptr<BuildNode> m_root;
+    std::vector<BuildNode*> m_buckets;
+    std::string m_tempDirectory;
+    
+    std::ofstream m_output;
+    uint64_t m_offset;
+};
+
+} // namespace
+
+bool buildOctree(OctreePointSource& source, const std::string& outputPath, const OctreeBuildOptions& options,
+                 OctreeBuildStats* stats) {
+    OctreeBuildStats localStats;
+    OctreeBuilder builder(source, options, stats ? *stats : localStats);
+    return builder.build(outputPath);
+}
+
+} // namespace mviz 
\ No newline at end of file
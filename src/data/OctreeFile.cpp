@@ -0,0 +1,164 @@
+#include "data/OctreeFile.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mviz {
+
+OctreeFile::OctreeFile()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_header(nullptr)
+    , m_nodes(nullptr)
+#ifdef _WIN32
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+#else
+    , m_fd(-1)
+#endif
+{
+}
+
+OctreeFile::~OctreeFile() {
+    close();
+}
+
+bool OctreeFile::open(const std::string& path) {
+    close();
+    m_path = path;
+
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    LARGE_INTEGER size;
+    if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size)) {
+        std::cerr << "Failed to open octree file: " << path << std::endl;
+        close();
+        return false;
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_mapping = m_size > 0 ? CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    m_data = m_mapping ? static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (m_fd < 0 || fstat(m_fd, &info) != 0) {
+        std::cerr << "Failed to open octree file: " << path << std::endl;
+        close();
+        return false;
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+        if (data != MAP_FAILED) {
+            m_data = static_cast<const uint8_t*>(data);
+            
+            // 节点按视点随机访问，关闭顺序预读
+            madvise(data, m_size, MADV_RANDOM);
+        }
+    }
+#endif
+
+    if (!m_data) {
+        std::cerr << "Failed to map octree file: " << path << std::endl;
+        close();
+        return false;
+    }
+    
+    // 校验文件头和节点表
+    m_header = reinterpret_cast<const OctreeFileHeader*>(m_data);
+    if (m_size < sizeof(OctreeFileHeader)
+        || std::memcmp(m_header->magic, OCTREE_FILE_MAGIC, sizeof(OCTREE_FILE_MAGIC)) != 0
+        || m_header->version != OCTREE_FILE_VERSION) {
+        std::cerr << "Not an octree file or unsupported version: " << path << std::endl;
+        close();
+        return false;
+    }
+    
+    const uint64_t tableBytes = static_cast<uint64_t>(m_header->nodeCount) * sizeof(OctreeNodeRecord);
+    if (m_header->nodeCount == 0 || m_header->nodeTableOffset % alignof(OctreeNodeRecord) != 0
+        || m_header->nodeTableOffset > m_size || tableBytes > m_size - m_header->nodeTableOffset) {
+        std::cerr << "Corrupted octree node table: " << path << std::endl;
+        close();
+        return false;
+    }
+    m_nodes = reinterpret_cast<const OctreeNodeRecord*>(m_data + m_header->nodeTableOffset);
+    
+    for (size_t i = 0; i < m_header->nodeCount; ++i) {
+        const OctreeNodeRecord& node = m_nodes[i];
+        const uint64_t bytes = getNodeDataSize(i);
+        bool valid = node.dataOffset <= m_size && bytes <= m_size - node.dataOffset;
+        for (int32_t child : node.children) {
+            valid = valid && (child < 0 || (child > static_cast<int32_t>(i) && child < static_cast<int32_t>(m_header->nodeCount)));
+        }
+        if (!valid) {
+            std::cerr << "Corrupted octree node " << i << ": " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+void OctreeFile::close() {
+#ifdef _WIN32
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_nodes = nullptr;
+}
+
+float OctreeFile::getNodeSpacing(size_t index) const {
+    return std::ldexp(m_header->spacing, -static_cast<int>(m_nodes[index].level));
+}
+
+void OctreeFile::prefetch(size_t index) const {
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<uint8_t*>(getNodeData(index));
+    range.NumberOfBytes = getNodeDataSize(index);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise要求起始地址按页对齐
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = m_nodes[index].dataOffset / pageSize * pageSize;
+    const size_t end = m_nodes[index].dataOffset + getNodeDataSize(index);
+    if (end > begin) {
+        madvise(const_cast<uint8_t*>(m_data) + begin, end - begin, MADV_WILLNEED);
+    }
+#endif
+}
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "data/PointAttributes.h"
+#include <cstring>
+#include <new>
+
+namespace mviz {
+
+size_t attributeTypeSize(AttributeType type) {
+    switch (type) {
+        case AttributeType::UINT8:
+            return 1;
+        case AttributeType::UINT16:
+            return 2;
+        case AttributeType::UINT32:
+        case AttributeType::INT32:
+        case AttributeType::FLOAT32:
+            return 4;
+        case AttributeType::FLOAT64:
+            return 8;
+    }
+    return 0;
+}
+
+bool isIntegerAttributeType(AttributeType type) {
+    return type != AttributeType::FLOAT32 && type != AttributeType::FLOAT64;
+}
+
+//-------------------- PointAttribute 实现 --------------------
+
+PointAttribute::PointAttribute(std::string name, AttributeType type, size_t components)
+    : m_name(std::move(name))
+    , m_type(type)
+    , m_components(components)
+    , m_size(0)
+    , m_capacity(0)
+{
+}
+
+PointAttribute::PointAttribute(const PointAttribute& other)
+    : m_name(other.m_name)
+    , m_type(other.m_type)
+    , m_components(other.m_components)
+    , m_size(0)
+    , m_capacity(0)
+{
+    reserve(other.m_size);
+    if (other.m_size > 0) {
+        std::memcpy(m_data.get(), other.m_data.get(), other.m_size * getElementSize());
+    }
+    m_size = other.m_size;
+}
+
+PointAttribute& PointAttribute::operator=(const PointAttribute& other) {
+    if (this != &other) {
+        PointAttribute copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+void PointAttribute::AlignedDeleter::operator()(uint8_t* data) const {
+    ::operator delete(data, std::align_val_t(ALIGNMENT));
+}
+
+void PointAttribute::resize(size_t count) {
+    reserve(count);
+    if (count > m_size) {
+        std::memset(m_data.get() + m_size * getElementSize(), 0, (count - m_size) * getElementSize());
+    }
+    m_size = count;
+}
+
+void PointAttribute::reserve(size_t count) {
+    if (count <= m_capacity) {
+        return;
+    }
+    
+    // 字节数按对齐取整，末尾按整个缓存行读取不会越界
+    const size_t elementSize = getElementSize();
+    const size_t bytes = (count * elementSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    std::unique_ptr<uint8_t[], AlignedDeleter> data(
+        static_cast<uint8_t*>(::operator new(bytes, std::align_val_t(ALIGNMENT))));
+    if (m_size > 0) {
+        std::memcpy(data.get(), m_data.get(), m_size * elementSize);
+    }
+    
+    m_data = std::move(data);
+    m_capacity = bytes / elementSize;
+}
+
+} // namespace mviz 
\ No newline at end of file
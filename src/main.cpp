@@ -1,4 +1,5 @@
 #include "core/Application.h"
+#include "core/SceneManager.h"
 #include <iostream>
 
 int main(int argc, char* argv[]) {
@@ -7,6 +8,11 @@ int main(int argc, char* argv[]) {
         if (!app.initialize()) {
             return -1;
         }
+        
+        // 可选参数：要显示的八叉树点云文件
+        if (argc > 1 && !app.getSceneManager()->loadOctreePointCloud("octree_point_cloud", "world", argv[1])) {
+            return -1;
+        }
         app.run();
         return 0;
     } catch (const std::exception& e) {
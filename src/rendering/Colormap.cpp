@@ -0,0 +1,87 @@
+#include "rendering/Colormap.h"
+#include <algorithm>
+#include <cmath>
+
+namespace mviz {
+
+namespace {
+
+uint8_t toByte(float value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// Turbo的多项式近似（Mikhailov, 2019），t在[0, 1]
+void turbo(float t, float rgb[3]) {
+    const float t2 = t * t, t3 = t2 * t, t4 = t3 * t, t5 = t4 * t;
+    rgb[0] = 0.13572138f + 4.61539260f * t - 42.66032258f * t2 + 132.13108234f * t3 - 152.94239396f * t4 + 59.28637943f * t5;
+    rgb[1] = 0.09140261f + 2.19418839f * t + 4.84296658f * t2 - 14.18503333f * t3 + 4.27729857f * t4 + 2.82956604f * t5;
+    rgb[2] = 0.10667330f + 12.64194608f * t - 60.58204836f * t2 + 110.36276771f * t3 - 89.90310912f * t4 + 27.34824973f * t5;
+}
+
+// Viridis的6次多项式拟合，t在[0, 1]
+void viridis(float t, float rgb[3]) {
+    static const float c[7][3] = {
+        { 0.2777273272234177f,  0.005407344544966578f,  0.3340998053353061f},
+        { 0.1050930431085774f,  1.404613529898575f,     1.384590162594685f},
+        {-0.3308618287255563f,  0.214847559468213f,     0.09509516302823659f},
+        {-4.634230498983486f,  -5.799100973351585f,   -19.33244095627987f},
+        { 6.228269936347081f,  14.17993336680509f,     56.69055260068105f},
+        { 4.776384997670288f, -13.74514537774601f,    -65.35303263337234f},
+        {-5.435455855934631f,   4.645852612178535f,    26.3124352495832f},
+    };
+    for (int channel = 0; channel < 3; ++channel) {
+        float value = c[6][channel];
+        for (int i = 5; i >= 0; --i) {
+            value = value * t + c[i][channel];
+        }
+        rgb[channel] = value;
+    }
+}
+
+// 标签调色板：色相按黄金分割角递增，饱和度和亮度交替变化，使相邻编号的颜色容易区分；0为灰色（通常表示未标注）
+void label(size_t index, float rgb[3]) {
+    if (index == 0) {
+        rgb[0] = rgb[1] = rgb[2] = 0.5f;
+        return;
+    }
+    
+    const float hue = std::fmod(index * 0.618033988749895f, 1.0f) * 6.0f;
+    const float saturation = index % 2 == 0 ? 0.65f : 0.85f;
+    const float value = index % 3 == 0 ? 0.75f : 0.95f;
+    
+    // HSV转RGB
+    const int sector = static_cast<int>(hue) % 6;
+    const float f = hue - std::floor(hue);
+    const float p = value * (1.0f - saturation);
+    const float q = value * (1.0f - saturation * f);
+    const float u = value * (1.0f - saturation * (1.0f - f));
+    const float table[6][3] = {{value, u, p}, {q, value, p}, {p, value, u}, {p, q, value}, {u, p, value}, {value, p, q}};
+    std::copy(table[sector], table[sector] + 3, rgb);
+}
+
+} // namespace
+
+void buildColormap(Colormap colormap, uint8_t* rgba) {
+    for (size_t i = 0; i < COLORMAP_SIZE; ++i) {
+        const float t = static_cast<float>(i) / (COLORMAP_SIZE - 1);
+        float rgb[3];
+        switch (colormap) {
+            case Colormap::TURBO:
+                turbo(t, rgb);
+                break;
+            case Colormap::VIRIDIS:
+                viridis(t, rgb);
+                break;
+            case Colormap::LABELS:
+                label(i, rgb);
+                break;
+        }
+        
+        rgba[4 * i + 0] = toByte(rgb[0]);
+        rgba[4 * i + 1] = toByte(rgb[1]);
+        rgba[4 * i + 2] = toByte(rgb[2]);
+        rgba[4 * i + 3] = 255;
+    }
+}
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "rendering/RenderTarget.h"
+#include <iostream>
+
+namespace mviz {
+
+RenderTarget::RenderTarget()
+    : m_framebuffer(0)
+    , m_colorBuffer(0)
+    , m_depthBuffer(0)
+    , m_width(0)
+    , m_height(0)
+    , m_complete(false)
+{
+}
+
+RenderTarget::~RenderTarget() {
+    release();
+}
+
+bool RenderTarget::resize(int width, int height) {
+    if (m_framebuffer != 0 && width == m_width && height == m_height) {
+        return m_complete;
+    }
+    
+    release();
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    
+    glGenRenderbuffers(1, &m_colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    
+    glGenRenderbuffers(1, &m_depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+    m_complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    if (!m_complete) {
+        std::cerr << "Error: Offscreen framebuffer is incomplete" << std::endl;
+    }
+    
+    m_width = width;
+    m_height = height;
+    return m_complete;
+}
+
+void RenderTarget::bind() {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+}
+
+void RenderTarget::blitToDefault(int x, int y) {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, m_width, m_height, x, y, x + m_width, y + m_height,
+                      GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderTarget::release() {
+    if (m_framebuffer != 0) {
+        glDeleteFramebuffers(1, &m_framebuffer);
+        m_framebuffer = 0;
+    }
+    if (m_colorBuffer != 0) {
+        glDeleteRenderbuffers(1, &m_colorBuffer);
+        m_colorBuffer = 0;
+    }
+    if (m_depthBuffer != 0) {
+        glDeleteRenderbuffers(1, &m_depthBuffer);
+        m_depthBuffer = 0;
+    }
+    m_width = 0;
+    m_height = 0;
+    m_complete = false;
+}
+
+} // namespace mviz 
\ No newline at end of file
@@ -7,7 +7,7 @@ namespace mviz {
 
 Renderer::Renderer()
     : m_camera(nullptr)
-    , m_tfManager(nullptr)
+    , m_tfSnapshot(nullptr)
     , m_sceneManager(nullptr)
     , m_axesVAO(0)
     , m_axesVBO(0)
@@ -22,6 +22,7 @@ Renderer::Renderer()
     , m_frameLabelSize(1.0f)
     , m_axisThickness(1.0f)
 {
+    m_colormapTextures.fill(0);
 }
 
 Renderer::~Renderer() {
@@ -47,6 +48,14 @@ Renderer::~Renderer() {
         glDeleteBuffers(1, &frame.vbo);
     }
     m_tfFrames.clear();
+    
+    // 清理色表纹理
+    for (GLuint& texture : m_colormapTextures) {
+        if (texture) {
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+    }
 }
 
 bool Renderer::initialize() {
@@ -253,12 +262,13 @@ void Renderer::drawGroundGrid(const std::string& referenceFrame) {
     // 使用着色器
     m_shader->use();
     
-    // 如果指定了特定的参考坐标系，获取从世界坐标系到该坐标系的变换
+    // 如果指定了特定的参考坐标系，获取把世界坐标系下的网格变换到该坐标系下的变换
     glm::mat4 model = glm::mat4(1.0f);
     
-    if (m_tfManager && referenceFrame != "world") {
+    if (m_tfSnapshot && referenceFrame != "world") {
         Transform worldToRef;
-        if (m_tfManager->lookupTransform("world", referenceFrame, worldToRef)) {
+        if (m_tfSnapshot->lookupTransform(m_tfSnapshot->findFrameId(referenceFrame),
+                                          m_tfSnapshot->getWorldFrameId(), worldToRef)) {
             // 创建变换矩阵 - 先旋转后平移
             glm::mat4 rotMat = glm::mat4_cast(worldToRef.rotation);
             model = glm::translate(glm::mat4(1.0f), worldToRef.translation) * rotMat;
@@ -308,13 +318,13 @@ void Renderer::createTFVisualization() {
 }
 
 void Renderer::updateTFVisualData() {
-    if (!m_tfManager) {
+    if (!m_tfSnapshot) {
         return;
     }
     
     // 获取TF坐标系之间的连接
     std::vector<std::pair<glm::vec3, glm::vec3>> connections;
-    m_tfManager->getConnectionsForRendering(connections);
+    m_tfSnapshot->getConnectionsForRendering(connections);
     
     // 准备TF连接线的顶点数据
     std::vector<float> tfLinesVertices;
@@ -353,16 +363,17 @@ void Renderer::updateTFVisualData() {
     }
     m_tfFrames.clear();
     
-    // 获取所有坐标系名称
-    std::vector<std::string> frameNames = m_tfManager->getAllFrameNames();
+    // 获取所有坐标系句柄
+    std::vector<FrameId> frameIds = m_tfSnapshot->getAllFrameIds();
     
     // 为每个坐标系创建一个小的坐标轴
     float axisSize = 0.2f; // 小坐标轴的大小
     
-    for (const auto& name : frameNames) {
+    for (FrameId id : frameIds) {
         TFFrameVisual frameVisual;
-        frameVisual.name = name;
-        frameVisual.position = m_tfManager->getFramePosition(name);
+        frameVisual.id = id;
+        frameVisual.name = m_tfSnapshot->getFrameName(id);
+        frameVisual.position = m_tfSnapshot->getFramePosition(id);
         
         // 使用相同的代码创建坐标轴，但应用偏移
         std::vector<float> axesVertices = {
@@ -409,7 +420,7 @@ void Renderer::updateTFVisualData() {
 }
 
 void Renderer::drawTFVisualization() {
-    if (!m_shader || !m_camera || !m_tfManager) {
+    if (!m_shader || !m_camera || !m_tfSnapshot) {
         return;
     }
     
@@ -440,6 +451,7 @@ void Renderer::drawTFVisualization() {
     }
     
     // 绘制TF坐标系
+    const FrameId worldFrame = m_tfSnapshot->getWorldFrameId();
     for (const auto& frame : m_tfFrames) {
         // 检查坐标系是否应该可见，或者是否应该显示标签
         // 如果是world坐标系，或者用户启用了显示标签，我们就显示坐标系
@@ -454,9 +466,9 @@ void Renderer::drawTFVisualization() {
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::translate(model, frame.position);
         
-        // 查找从世界坐标系到当前坐标系的变换（如果可用，则应用旋转）
+        // 查找当前坐标系在世界坐标系下的姿态（如果可用，则应用旋转）
         Transform worldToFrame;
-        if (m_tfManager->lookupTransform("world", frame.name, worldToFrame)) {
+        if (m_tfSnapshot->lookupTransform(worldFrame, frame.id, worldToFrame)) {
             // 应用旋转（四元数转矩阵）
             glm::mat4 rotMat = glm::mat4_cast(worldToFrame.rotation);
             // 只提取旋转部分，不要应用平移（因为我们已经使用frame.position平移了）
@@ -491,6 +503,26 @@ void Renderer::drawTFVisualization() {
     glLineWidth(1.0f);
 }
 
+GLuint Renderer::getColormapTexture(Colormap colormap) {
+    GLuint& texture = m_colormapTextures[static_cast<size_t>(colormap)];
+    if (texture) {
+        return texture;
+    }
+    
+    uint8_t rgba[4 * COLORMAP_SIZE];
+    buildColormap(colormap, rgba);
+    
+    const GLint filter = isDiscreteColormap(colormap) ? GL_NEAREST : GL_LINEAR;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_1D, texture);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA8, COLORMAP_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    return texture;
+}
+
 void Renderer::clear() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -0,0 +1,157 @@
+#include "rendering/StreamingBuffer.h"
+
+namespace mviz {
+
+namespace {
+
+// 每段的起始偏移按此对齐
+constexpr size_t REGION_ALIGNMENT = 256;
+
+// 等待栅栏时每次的超时（纳秒）
+constexpr GLuint64 FENCE_TIMEOUT = 1000000000;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+StreamingBuffer::StreamingBuffer()
+    : m_buffer(0)
+    , m_persistent(GLAD_GL_ARB_buffer_storage != 0)
+    , m_mapped(nullptr)
+    , m_regionCapacity(0)
+    , m_region(REGION_COUNT - 1)
+{
+    m_fences.fill(nullptr);
+}
+
+StreamingBuffer::~StreamingBuffer() {
+    release();
+}
+
+void* StreamingBuffer::beginWrite(size_t size, size_t& offset) {
+    if (m_buffer == 0 || size > m_regionCapacity) {
+        // 留出余量，避免点数小幅波动时反复重新分配
+        allocate(alignUp(size + size / 2, REGION_ALIGNMENT));
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    }
+    
+    m_region = (m_region + 1) % REGION_COUNT;
+    offset = m_region * m_regionCapacity;
+    
+    if (m_persistent) {
+        // 三重缓冲下该段通常早已被GPU读取完毕，等待只在GPU落后超过两帧时发生
+        waitRegion(m_region);
+        return m_mapped ? m_mapped + offset : nullptr;
+    }
+    
+    // 该段仍被GPU使用时废弃旧存储，驱动会在GPU读取完成后回收，CPU无需等待
+    GLsync fence = m_fences[m_region];
+    if (fence) {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            glBufferData(GL_ARRAY_BUFFER, REGION_COUNT * m_regionCapacity, nullptr, GL_STREAM_DRAW);
+            clearFences();
+        } else {
+            glDeleteSync(fence);
+            m_fences[m_region] = nullptr;
+        }
+    }
+    
+    return glMapBufferRange(GL_ARRAY_BUFFER, offset, m_regionCapacity,
+                            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+bool StreamingBuffer::endWrite() {
+    // 一致性持久映射的写入对之后提交的命令直接可见
+    if (m_persistent) {
+        return true;
+    }
+    
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    return glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+}
+
+void StreamingBuffer::fence() {
+    if (m_buffer == 0) {
+        return;
+    }
+    
+    // 每次绘制后替换栅栏，保证记录的是该段最后一次被使用的位置
+    if (m_fences[m_region]) {
+        glDeleteSync(m_fences[m_region]);
+    }
+    m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void StreamingBuffer::allocate(size_t regionCapacity) {
+    const size_t totalSize = REGION_COUNT * regionCapacity;
+    
+    // 旧存储可能仍在被GPU读取，删除缓冲区或废弃存储后由驱动在读取完成后回收
+    clearFences();
+    
+    if (m_persistent) {
+        // 持久映射的存储大小不可变，只能重新创建
+        if (m_buffer != 0) {
+            glDeleteBuffers(1, &m_buffer);
+            m_buffer = 0;
+            m_mapped = nullptr;
+        }
+        
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &m_buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        glBufferStorage(GL_ARRAY_BUFFER, totalSize, nullptr, flags);
+        m_mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, totalSize, flags));
+    } else {
+        if (m_buffer == 0) {
+            glGenBuffers(1, &m_buffer);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        glBufferData(GL_ARRAY_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+    }
+    
+    m_regionCapacity = regionCapacity;
+    m_region = REGION_COUNT - 1;
+}
+
+void StreamingBuffer::waitRegion(size_t region) {
+    GLsync fence = m_fences[region];
+    if (!fence) {
+        return;
+    }
+    
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+    while (status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(fence, 0, FENCE_TIMEOUT);
+    }
+    
+    glDeleteSync(fence);
+    m_fences[region] = nullptr;
+}
+
+void StreamingBuffer::clearFences() {
+    for (GLsync& fence : m_fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+}
+
+void StreamingBuffer::release() {
+    clearFences();
+    
+    // 删除缓冲区时映射会被自动解除
+    if (m_buffer != 0) {
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_mapped = nullptr;
+    m_regionCapacity = 0;
+    m_region = REGION_COUNT - 1;
+}
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "rendering/UploadWorker.h"
+#include <GLFW/glfw3.h>
+#include <iostream>
+
+namespace mviz {
+
+//-------------------- UploadTicket 实现 --------------------
+
+bool UploadTicket::isComplete() {
+    if (m_complete) {
+        return true;
+    }
+    if (!m_submitted.load(std::memory_order_acquire)) {
+        return false;
+    }
+    
+    // 不等待，只查询栅栏状态
+    GLenum status = glClientWaitSync(m_fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        return false;
+    }
+    
+    glDeleteSync(m_fence);
+    m_fence = nullptr;
+    m_complete = true;
+    return true;
+}
+
+//-------------------- UploadWorker 实现 --------------------
+
+std::shared_ptr<UploadWorker> UploadWorker::create(GLFWwindow* mainWindow) {
+    // 沿用主窗口的上下文设置（版本、配置文件），只隐藏窗口
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* context = glfwCreateWindow(1, 1, "mviz upload", nullptr, mainWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    
+    if (!context) {
+        std::cerr << "Failed to create shared upload context" << std::endl;
+        return nullptr;
+    }
+    
+    return std::shared_ptr<UploadWorker>(new UploadWorker(context));
+}
+
+UploadWorker::UploadWorker(GLFWwindow* context)
+    : m_context(context)
+    , m_stopping(false)
+{
+    m_thread = std::thread(&UploadWorker::run, this);
+}
+
+UploadWorker::~UploadWorker() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+    
+    glfwDestroyWindow(m_context);
+}
+
+std::shared_ptr<UploadTicket> UploadWorker::submit(std::function<void()> task) {
+    auto ticket = std::make_shared<UploadTicket>();
+    enqueue(Task{std::move(task), ticket});
+    return ticket;
+}
+
+void UploadWorker::discard(std::shared_ptr<UploadTicket> ticket, std::function<void()> cleanup) {
+    // 任务按提交顺序执行，此时被放弃的任务已经执行完毕
+    enqueue(Task{[ticket, cleanup]() {
+        if (cleanup) {
+            cleanup();
+        }
+        if (ticket && ticket->m_fence) {
+            glDeleteSync(ticket->m_fence);
+            ticket->m_fence = nullptr;
+        }
+    }, nullptr});
+}
+
+void UploadWorker::enqueue(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void UploadWorker::run() {
+    glfwMakeContextCurrent(m_context);
+    
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            
+            // 退出前先执行完剩余的任务（如删除缓冲区）
+            if (m_tasks.empty()) {
+                break;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        
+        task.function();
+        
+        // 插入栅栏并提交命令，使渲染线程能观察到栅栏被触发
+        if (task.ticket) {
+            task.ticket->m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+            task.ticket->m_submitted.store(true, std::memory_order_release);
+        }
+    }
+    
+    glfwMakeContextCurrent(nullptr);
+}
+
+} // namespace mviz 
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "ui/UIManager.h"
 #include "core/SceneManager.h"
+#include "visualization/PointCloudVisual.h"
+#include "visualization/OctreePointCloudVisual.h"
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <iostream>
 
 namespace mviz {
@@ -111,6 +114,10 @@ void UIManager::renderControlPanel(SceneManager& sceneManager) {
         renderCoordinateSystemSettings(sceneManager);
         ImGui::Separator();
 
+        // 渲染点数预算设置
+        renderPointBudgetSettings(sceneManager);
+        ImGui::Separator();
+
         // 渲染可视化对象列表
         renderVisualObjectList(sceneManager);
     }
@@ -173,6 +180,44 @@ void UIManager::renderCoordinateSystemSettings(SceneManager& sceneManager) {
     }
 }
 
+void UIManager::renderPointBudgetSettings(SceneManager& sceneManager) {
+    if (ImGui::CollapsingHeader("Point Budget", ImGuiTreeNodeFlags_DefaultOpen)) {
+        // 预算以百万点为单位调节，0表示不限制
+        float budgetMillions = sceneManager.getPointBudget() / 1.0e6f;
+        if (ImGui::SliderFloat("Budget (M)", &budgetMillions, 0.0f, 50.0f, "%.1f")) {
+            sceneManager.setPointBudget(static_cast<size_t>(budgetMillions * 1.0e6f));
+        }
+        
+        // 目标帧率，0表示不按帧时间调整
+        float targetFrameRate = sceneManager.getTargetFrameRate();
+        if (ImGui::SliderFloat("Target FPS", &targetFrameRate, 0.0f, 144.0f, "%.0f")) {
+            sceneManager.setTargetFrameRate(targetFrameRate);
+        }
+        
+        const double frameTime = sceneManager.getFrameTime();
+        ImGui::TextDisabled("Effective %.2fM, %.1f ms (%.0f FPS)", sceneManager.getEffectivePointBudget() / 1.0e6,
+                            frameTime * 1000.0, frameTime > 0.0 ? 1.0 / frameTime : 0.0);
+        
+        // 渐进绘制：相机运动时使用交互预算，静止后分多帧补全
+        bool progressive = sceneManager.getProgressiveRendering();
+        if (ImGui::Checkbox("Progressive Rendering", &progressive)) {
+            sceneManager.setProgressiveRendering(progressive);
+        }
+        
+        float interactiveMillions = sceneManager.getInteractivePointBudget() / 1.0e6f;
+        if (ImGui::SliderFloat("Moving (M)", &interactiveMillions, 0.0f, 20.0f, "%.1f")) {
+            sceneManager.setInteractivePointBudget(static_cast<size_t>(interactiveMillions * 1.0e6f));
+        }
+        
+        if (sceneManager.isCameraMoving()) {
+            ImGui::TextDisabled("Camera moving");
+        } else if (sceneManager.getProgressivePassCount() > 0) {
+            ImGui::TextDisabled("Refined %zu / %zu passes", sceneManager.getProgressivePass(),
+                                sceneManager.getProgressivePassCount());
+        }
+    }
+}
+
 void UIManager::renderVisualObjectList(SceneManager& sceneManager) {
     ImGui::Text("Visualization Objects");
     
@@ -210,6 +255,19 @@ void UIManager::renderVisualObjectList(SceneManager& sceneManager) {
                 if (ImGui::Checkbox(name.c_str(), &isVisible)) {
                     object->setVisible(isVisible);
                 }
+                
+                // 视锥体剔除后实际绘制的点数
+                if (auto pointCloud = std::dynamic_pointer_cast<PointCloudVisual>(object)) {
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("%zu / %zu", pointCloud->getDrawnPointCount(), pointCloud->getPointCount());
+                    renderPointCloudColorSettings(name, *pointCloud);
+                    renderPointCloudFilterSettings(name, *pointCloud);
+                } else if (auto octree = std::dynamic_pointer_cast<OctreePointCloudVisual>(object)) {
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("%zu / %zu", octree->getDrawnPointCount(), octree->getTotalPointCount());
+                    ImGui::TextDisabled("  %zu nodes, %.1f MB cached", octree->getDrawnNodeCount(),
+                                        octree->getCachedBytes() / (1024.0 * 1024.0));
+                }
             }
         }
         
@@ -223,4 +281,129 @@ void UIManager::renderVisualObjectList(SceneManager& sceneManager) {
     }
 }
 
+void UIManager::renderPointCloudColorSettings(const std::string& name, PointCloudVisual& pointCloud) {
+    using ColorSource = PointCloudVisual::ColorSource;
+    static const char* sourceNames[] = {"RGB", "Height", "Intensity", "Ring", "Label"};
+    static const char* colormapNames[] = {"Turbo", "Viridis", "Labels"};
+    
+    ImGui::PushID(name.c_str());
+    ImGui::Indent();
+    
+    // 只列出点云中存在的颜色来源
+    const int currentSource = static_cast<int>(pointCloud.getColorSource());
+    if (ImGui::BeginCombo("Color", sourceNames[currentSource])) {
+        for (int i = 0; i < IM_ARRAYSIZE(sourceNames); ++i) {
+            const ColorSource source = static_cast<ColorSource>(i);
+            if (!pointCloud.hasColorSource(source)) {
+                continue;
+            }
+            if (ImGui::Selectable(sourceNames[i], i == currentSource)) {
+                pointCloud.setColorSource(source);
+                
+                // 线束编号和标签是类别值，默认使用离散色表
+                if (source == ColorSource::RING || source == ColorSource::LABEL) {
+                    pointCloud.setColormap(Colormap::LABELS);
+                } else if (isDiscreteColormap(pointCloud.getColormap())) {
+                    pointCloud.setColormap(Colormap::TURBO);
+                }
+            }
+        }
+        ImGui::EndCombo();
+    }
+    
+    if (pointCloud.getColorSource() != ColorSource::RGB) {
+        int colormap = static_cast<int>(pointCloud.getColormap());
+        if (ImGui::Combo("Colormap", &colormap, colormapNames, IM_ARRAYSIZE(colormapNames))) {
+            pointCloud.setColormap(static_cast<Colormap>(colormap));
+        }
+        
+        // 离散色表按整数值取色，不使用范围
+        if (!isDiscreteColormap(pointCloud.getColormap())) {
+            bool autoRange = pointCloud.getAutoScalarRange();
+            if (ImGui::Checkbox("Auto range", &autoRange)) {
+                pointCloud.setAutoScalarRange(autoRange);
+            }
+            
+            float min, max;
+            pointCloud.getScalarRange(min, max);
+            const float speed = std::max((max - min) * 0.005f, 0.001f);
+            if (ImGui::DragFloatRange2("Range", &min, &max, speed)) {
+                pointCloud.setScalarRange(min, max);
+            }
+        }
+    }
+    
+    ImGui::Unindent();
+    ImGui::PopID();
+}
+
+void UIManager::renderPointCloudFilterSettings(const std::string& name, PointCloudVisual& pointCloud) {
+    using ColorSource = PointCloudVisual::ColorSource;
+    static const char* scalarNames[] = {"Intensity", "Ring", "Label"};
+    static const ColorSource scalarSources[] = {ColorSource::INTENSITY, ColorSource::RING, ColorSource::LABEL};
+    
+    ImGui::PushID(name.c_str());
+    ImGui::Indent();
+    
+    if (ImGui::TreeNode("Filters")) {
+        // 在副本上编辑，有改动时整体设置，着色器参数在下一次绘制时更新
+        PointCloudVisual::PointFilter filter = pointCloud.getFilter();
+        bool changed = false;
+        
+        changed |= ImGui::Checkbox("Crop box", &filter.cropEnabled);
+        if (filter.cropEnabled) {
+            changed |= ImGui::DragFloat3("Center", &filter.cropCenter.x, 0.01f);
+            changed |= ImGui::DragFloat3("Half size", &filter.cropHalfSize.x, 0.01f, 0.0f, 1e6f);
+            changed |= ImGui::DragFloat3("Rotation", &filter.cropRotation.x, 0.5f, -180.0f, 180.0f, "%.1f deg");
+        }
+        
+        changed |= ImGui::Checkbox("Range band", &filter.rangeEnabled);
+        if (filter.rangeEnabled) {
+            changed |= ImGui::DragFloatRange2("Range", &filter.minRange, &filter.maxRange, 0.05f, 0.0f, 1e6f);
+        }
+        
+        // 只能按点云中存在的标量属性过滤
+        int available = 0;
+        for (ColorSource source : scalarSources) {
+            available += pointCloud.hasColorSource(source) ? 1 : 0;
+        }
+        if (available > 0) {
+            changed |= ImGui::Checkbox("Threshold", &filter.scalarEnabled);
+        }
+        if (available > 0 && filter.scalarEnabled) {
+            int current = 0;
+            for (int i = 0; i < IM_ARRAYSIZE(scalarSources); ++i) {
+                if (scalarSources[i] == filter.scalarSource) {
+                    current = i;
+                }
+            }
+            if (ImGui::BeginCombo("Attribute", scalarNames[current])) {
+                for (int i = 0; i < IM_ARRAYSIZE(scalarSources); ++i) {
+                    if (pointCloud.hasColorSource(scalarSources[i]) && ImGui::Selectable(scalarNames[i], i == current)) {
+                        filter.scalarSource = scalarSources[i];
+                        changed = true;
+                    }
+                }
+                ImGui::EndCombo();
+            }
+            const float speed = std::max((filter.scalarMax - filter.scalarMin) * 0.005f, 0.001f);
+            changed |= ImGui::DragFloatRange2("Values", &filter.scalarMin, &filter.scalarMax, speed);
+        }
+        
+        changed |= ImGui::Checkbox("Clip plane", &filter.planeEnabled);
+        if (filter.planeEnabled) {
+            changed |= ImGui::DragFloat3("Normal", &filter.planeNormal.x, 0.01f, -1.0f, 1.0f);
+            changed |= ImGui::DragFloat("Offset", &filter.planeOffset, 0.01f);
+        }
+        
+        if (changed) {
+            pointCloud.setFilter(filter);
+        }
+        ImGui::TreePop();
+    }
+    
+    ImGui::Unindent();
+    ImGui::PopID();
+}
+
 } // namespace mviz 
\ No newline at end of file
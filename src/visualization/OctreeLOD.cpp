@@ -0,0 +1,84 @@
+#include "visualization/OctreeLOD.h"
+#include "core/Camera.h"
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace mviz {
+
+OctreeView OctreeView::fromCamera(const Camera& camera, const glm::mat4& model, int viewportHeight) {
+    const glm::mat4 projection = camera.getProjectionMatrix();
+    
+    OctreeView view;
+    view.frustum = Frustum::fromMatrix(projection * camera.getViewMatrix() * model);
+    view.eye = glm::vec3(glm::inverse(model) * glm::vec4(camera.getPosition(), 1.0f));
+    
+    // 透视投影矩阵的[1][1]为1 / tan(fov / 2)
+    view.projectionScale = 0.5f * viewportHeight * projection[1][1];
+    return view;
+}
+
+float octreeScreenError(const OctreeFile& file, uint32_t node, const OctreeView& view) {
+    const OctreeNodeRecord& record = file.getNode(node);
+    const glm::vec3 min(record.min[0], record.min[1], record.min[2]);
+    const glm::vec3 center = min + glm::vec3(record.size * 0.5f);
+    const float radius = record.size * 0.8660254f;
+    
+    // 用到包围球的距离，视点靠近节点时误差迅速增大
+    const float distance = glm::length(center - view.eye) - radius;
+    if (distance <= 0.0f) {
+        return std::numeric_limits<float>::infinity();
+    }
+    return file.getNodeSpacing(node) * view.projectionScale / distance;
+}
+
+void selectOctreeNodes(const OctreeFile& file, const OctreeView& view, const OctreeLODOptions& options,
+                       const std::function<bool(uint32_t)>& isLoaded, OctreeSelection& selection) {
+    selection.clear();
+    if (!file.isOpen()) {
+        return;
+    }
+    
+    auto inFrustum = [&](uint32_t node) {
+        const OctreeNodeRecord& record = file.getNode(node);
+        const glm::vec3 min(record.min[0], record.min[1], record.min[2]);
+        return view.frustum.intersectsBox(min, min + glm::vec3(record.size));
+    };
+    
+    // 按屏幕空间误差从大到小处理，预算耗尽时保留的是对画面影响最大的节点
+    using Entry = std::pair<float, uint32_t>;
+    std::priority_queue<Entry> queue;
+    if (inFrustum(0)) {
+        queue.emplace(octreeScreenError(file, 0, view), 0);
+    }
+    
+    size_t selectedPoints = 0;
+    while (!queue.empty()) {
+        const uint32_t node = queue.top().second;
+        queue.pop();
+        
+        const OctreeNodeRecord& record = file.getNode(node);
+        if (selectedPoints + record.pointCount > options.pointBudget) {
+            break;
+        }
+        selectedPoints += record.pointCount;
+        
+        if (!isLoaded(node)) {
+            selection.missing.push_back(node);
+            continue;
+        }
+        selection.visible.push_back(node);
+        selection.visiblePoints += record.pointCount;
+        
+        for (int32_t child : record.children) {
+            if (child < 0 || !inFrustum(child)) continue;
+            
+            const float error = octreeScreenError(file, child, view);
+            if (error > options.maxScreenError) {
+                queue.emplace(error, child);
+            }
+        }
+    }
+}
+
+} // namespace mviz 
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include "visualization/OctreePointCloudVisual.h"
+#include "core/Camera.h"
+#include "data/OctreeFile.h"
+#include "rendering/Renderer.h"
+#include "rendering/UploadWorker.h"
+#include "visualization/PointPacking.h"
+#include <algorithm>
+#include <iostream>
+
+namespace mviz {
+
+namespace {
+
+// 默认的显存上限
+constexpr size_t DEFAULT_GPU_MEMORY_LIMIT = size_t(512) << 20;
+
+// 上传线程中同时进行的最大加载数，限制排队的任务数以便快速响应视点变化
+constexpr size_t MAX_PENDING_LOADS = 8;
+
+// 没有上传线程时每帧在渲染线程中加载的最大节点数
+constexpr size_t MAX_SYNC_LOADS_PER_FRAME = 4;
+
+} // namespace
+
+OctreePointCloudVisual::OctreePointCloudVisual(const std::string& name, const std::string& frame_id)
+    : VisualObject(name, frame_id)
+    , m_gpuMemoryLimit(DEFAULT_GPU_MEMORY_LIMIT)
+    , m_cachedBytes(0)
+    , m_frame(0)
+    , m_pointSize(1.0f)
+    , m_uniformColor(1.0f, 1.0f, 1.0f)
+    , m_drawnPointCount(0)
+{
+}
+
+OctreePointCloudVisual::~OctreePointCloudVisual() {
+    releaseAllNodes();
+}
+
+bool OctreePointCloudVisual::open(const std::string& path) {
+    releaseAllNodes();
+    
+    auto file = std::make_shared<OctreeFile>();
+    if (!file->open(path)) {
+        m_file.reset();
+        m_nodes.clear();
+        return false;
+    }
+    
+    m_file = std::move(file);
+    m_nodes.assign(m_file->getNodeCount(), NodeCache());
+    return true;
+}
+
+size_t OctreePointCloudVisual::getTotalPointCount() const {
+    return m_file ? m_file->getHeader().pointCount : 0;
+}
+
+bool OctreePointCloudVisual::getLocalBounds(glm::vec3& min, glm::vec3& max) const {
+    if (!m_file) {
+        return false;
+    }
+    
+    const OctreeFileHeader& header = m_file->getHeader();
+    min = glm::vec3(header.min[0], header.min[1], header.min[2]);
+    max = min + glm::vec3(header.size);
+    return true;
+}
+
+void OctreePointCloudVisual::updateResources() {
+    // 整个点云被剔除时本帧不会调用draw()
+    m_drawnPointCount = 0;
+    
+    if (!m_file || !m_camera) {
+        m_selection.clear();
+        return;
+    }
+    ++m_frame;
+    
+    finishLoads();
+    
+    // 屏幕空间误差以像素计，需要当前视口的高度
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const OctreeView view = OctreeView::fromCamera(*m_camera, m_model_matrix, std::max(viewport[3], 1));
+    
+    selectOctreeNodes(*m_file, view, m_lodOptions, [this](uint32_t node) {
+        return m_nodes[node].state == NodeCache::State::LOADED;
+    }, m_selection);
+    
+    for (uint32_t node : m_selection.visible) {
+        m_nodes[node].lastUsedFrame = m_frame;
+    }
+    requestLoads();
+}
+
+void OctreePointCloudVisual::draw(Renderer& renderer, const glm::mat4& view_projection_matrix) {
+    if (!m_visible || m_selection.visible.empty()) {
+        return;
+    }
+    
+    renderer.useShader(Renderer::ShaderType::POINT_CLOUD);
+    auto shader = renderer.getActiveShader();
+    if (!shader) {
+        std::cerr << "Error: No active shader for point cloud rendering" << std::endl;
+        return;
+    }
+    shader->use();
+    
+    shader->setMat4("view_projection", view_projection_matrix);
+    shader->setMat4("model", m_model_matrix);
+    shader->setFloat("point_size", m_pointSize);
+    shader->setVec3("uniform_color", m_uniformColor);
+    shader->setInt("color_mode", m_file->hasColors() ? 0 : 1);
+    shader->setInt("filter_flags", 0);
+    shader->setFloat("decay_time", 0.0f);
+    
+    // 每个节点的位置相对于自己的立方体量化
+    for (uint32_t node : m_selection.visible) {
+        const NodeCache& cache = m_nodes[node];
+        shader->setVec3("position_scale", cache.scale);
+        shader->setVec3("position_offset", cache.offset);
+        
+        glBindVertexArray(cache.vao);
+        glDrawArrays(GL_POINTS, 0, m_file->getNode(node).pointCount);
+    }
+    glBindVertexArray(0);
+    m_drawnPointCount = m_selection.visiblePoints;
+    
+    // 恢复到基本着色器
+    renderer.useShader(Renderer::ShaderType::BASIC);
+}
+
+void OctreePointCloudVisual::finishLoads() {
+    auto finished = std::remove_if(m_loadingNodes.begin(), m_loadingNodes.end(), [this](uint32_t node) {
+        NodeCache& cache = m_nodes[node];
+        if (!cache.load->ticket->isComplete()) {
+            return false;
+        }
+        
+        const GLuint buffer = cache.load->buffer;
+        cache.load.reset();
+        activateNode(node, buffer);
+        return true;
+    });
+    m_loadingNodes.erase(finished, m_loadingNodes.end());
+}
+
+void OctreePointCloudVisual::requestLoads() {
+    size_t syncLoads = 0;
+    for (uint32_t node : m_selection.missing) {
+        NodeCache& cache = m_nodes[node];
+        if (cache.state == NodeCache::State::LOADING) {
+            cache.lastUsedFrame = m_frame;
+            continue;
+        }
+        
+        // 腾出空间；本帧选中的节点都无法淘汰时停止加载
+        const size_t bytes = m_file->getNodeDataSize(node);
+        if (bytes > m_gpuMemoryLimit || !evictUntil(m_gpuMemoryLimit - bytes)) {
+            break;
+        }
+        
+        if (m_uploadWorker) {
+            if (m_loadingNodes.size() >= MAX_PENDING_LOADS) {
+                break;
+            }
+            
+            // 在上传线程中读取映射的文件（缺页时从磁盘读入）并直接上传，不经过中间拷贝
+            auto load = std::make_shared<NodeLoad>();
+            load->worker = m_uploadWorker;
+            std::shared_ptr<OctreeFile> file = m_file;
+            load->ticket = m_uploadWorker->submit([file, load, node, bytes]() {
+                glGenBuffers(1, &load->buffer);
+                glBindBuffer(GL_ARRAY_BUFFER, load->buffer);
+                glBufferData(GL_ARRAY_BUFFER, bytes, file->getNodeData(node), GL_STATIC_DRAW);
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+            });
+            cache.state = NodeCache::State::LOADING;
+            cache.load = std::move(load);
+            cache.lastUsedFrame = m_frame;
+            m_cachedBytes += bytes;
+            m_loadingNodes.push_back(node);
+        } else if (syncLoads < MAX_SYNC_LOADS_PER_FRAME) {
+            GLuint buffer = 0;
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glBufferData(GL_ARRAY_BUFFER, bytes, m_file->getNodeData(node), GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            
+            cache.lastUsedFrame = m_frame;
+            m_cachedBytes += bytes;
+            activateNode(node, buffer);
+            ++syncLoads;
+        } else {
+            // 超出本帧的加载数：让系统先在后台读入，之后加载时不必等待磁盘
+            m_file->prefetch(node);
+        }
+    }
+}
+
+void OctreePointCloudVisual::activateNode(uint32_t node, GLuint buffer) {
+    NodeCache& cache = m_nodes[node];
+    const OctreeNodeRecord& record = m_file->getNode(node);
+    
+    // VAO不在上下文之间共享，在渲染线程中创建
+    glGenVertexArrays(1, &cache.vao);
+    glBindVertexArray(cache.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(0, 3, GL_SHORT, GL_FALSE, OCTREE_POSITION_BYTES, (void*)0);
+    glEnableVertexAttribArray(0);
+    if (m_file->hasColors()) {
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(uint32_t),
+                              (void*)(size_t(record.pointCount) * OCTREE_POSITION_BYTES));
+        glEnableVertexAttribArray(1);
+    } else {
+        glDisableVertexAttribArray(1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    
+    const glm::vec3 min(record.min[0], record.min[1], record.min[2]);
+    computeQuantization(min, min + glm::vec3(record.size), cache.scale, cache.offset);
+    cache.vbo = buffer;
+    cache.state = NodeCache::State::LOADED;
+}
+
+bool OctreePointCloudVisual::evictUntil(size_t targetBytes) {
+    if (m_cachedBytes <= targetBytes) {
+        return true;
+    }
+    
+    // 按最近使用的帧从旧到新淘汰本帧未使用的已加载节点
+    std::vector<uint32_t> candidates;
+    for (uint32_t node = 0; node < m_nodes.size(); ++node) {
+        const NodeCache& cache = m_nodes[node];
+        if (cache.state == NodeCache::State::LOADED && cache.lastUsedFrame < m_frame) {
+            candidates.push_back(node);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+        return m_nodes[a].lastUsedFrame < m_nodes[b].lastUsedFrame;
+    });
+    
+    for (uint32_t node : candidates) {
+        if (m_cachedBytes <= targetBytes) {
+            break;
+        }
+        releaseNode(node);
+    }
+    return m_cachedBytes <= targetBytes;
+}
+
+void OctreePointCloudVisual::releaseNode(uint32_t node) {
+    NodeCache& cache = m_nodes[node];
+    if (cache.state == NodeCache::State::UNLOADED) {
+        return;
+    }
+    
+    if (cache.state == NodeCache::State::LOADING) {
+        // 放弃加载，由执行加载的上传线程在加载完成后删除缓冲区（之后可能已更换或清除上传线程）
+        std::shared_ptr<NodeLoad> load = std::move(cache.load);
+        std::shared_ptr<UploadWorker> worker = std::move(load->worker);
+        worker->discard(load->ticket, [load]() {
+            glDeleteBuffers(1, &load->buffer);
+        });
+        m_loadingNodes.erase(std::find(m_loadingNodes.begin(), m_loadingNodes.end(), node));
+    } else {
+        glDeleteVertexArrays(1, &cache.vao);
+        glDeleteBuffers(1, &cache.vbo);
+    }
+    
+    m_cachedBytes -= m_file->getNodeDataSize(node);
+    cache = NodeCache();
+}
+
+void OctreePointCloudVisual::releaseAllNodes() {
+    for (uint32_t node = 0; node < m_nodes.size(); ++node) {
+        releaseNode(node);
+    }
+    m_selection.clear();
+}
+
+} // namespace mviz 
\ No newline at end of file
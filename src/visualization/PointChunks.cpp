@@ -0,0 +1,120 @@
+#include "visualization/PointChunks.h"
+#include <algorithm>
+
+namespace mviz {
+
+namespace {
+
+// 每个轴上的单元数为2^CELL_BITS
+constexpr int CELL_BITS = 5;
+constexpr uint32_t CELLS_PER_AXIS = 1u << CELL_BITS;
+constexpr uint32_t CELL_COUNT = CELLS_PER_AXIS * CELLS_PER_AXIS * CELLS_PER_AXIS;
+
+// 把CELL_BITS位的值展开到每3位中的最低位
+inline uint32_t spreadBits(uint32_t value) {
+    uint32_t result = 0;
+    for (int bit = 0; bit < CELL_BITS; ++bit) {
+        result |= ((value >> bit) & 1u) << (3 * bit);
+    }
+    return result;
+}
+
+// 坐标在包围盒中所在单元的下标，超出包围盒（或NaN）时截断到边界单元
+inline uint32_t cellCoordinate(float value, float min, float invSize) {
+    const float cell = (value - min) * invSize;
+    if (!(cell > 0.0f)) {
+        return 0;
+    }
+    return std::min(static_cast<uint32_t>(cell), CELLS_PER_AXIS - 1);
+}
+
+// xorshift32伪随机数，只用于打乱点序，不要求统计质量
+inline uint32_t nextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+} // namespace
+
+void buildPointChunks(const glm::vec3* points, size_t count, const glm::vec3& min, const glm::vec3& max,
+                      size_t maxChunkPoints, std::vector<uint32_t>& order, std::vector<PointChunk>& chunks) {
+    order.resize(count);
+    chunks.clear();
+    if (count == 0) {
+        return;
+    }
+    maxChunkPoints = std::max<size_t>(maxChunkPoints, 1);
+    
+    // 单元坐标到Morton码的查找表，三个轴分别偏移0、1、2位
+    uint32_t morton[CELLS_PER_AXIS];
+    for (uint32_t i = 0; i < CELLS_PER_AXIS; ++i) {
+        morton[i] = spreadBits(i);
+    }
+    
+    glm::vec3 invSize(0.0f);
+    for (int axis = 0; axis < 3; ++axis) {
+        const float extent = max[axis] - min[axis];
+        invSize[axis] = extent > 0.0f ? CELLS_PER_AXIS / extent : 0.0f;
+    }
+    
+    // 计数排序：每个点的单元只计算一次，重排只需一次遍历
+    std::vector<uint16_t> cells(count);
+    std::vector<uint32_t> offsets(CELL_COUNT + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec3& p = points[i];
+        const uint32_t cell = morton[cellCoordinate(p.x, min.x, invSize.x)]
+                            | morton[cellCoordinate(p.y, min.y, invSize.y)] << 1
+                            | morton[cellCoordinate(p.z, min.z, invSize.z)] << 2;
+        cells[i] = static_cast<uint16_t>(cell);
+        ++offsets[cell + 1];
+    }
+    for (uint32_t cell = 0; cell < CELL_COUNT; ++cell) {
+        offsets[cell + 1] += offsets[cell];
+    }
+    
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        order[cursor[cells[i]]++] = static_cast<uint32_t>(i);
+    }
+    
+    // 按Morton序合并相邻的单元，块的边界只落在单元之间（单元超过上限时除外）
+    size_t chunkBegin = 0;
+    for (uint32_t cell = 0; cell < CELL_COUNT; ++cell) {
+        const size_t cellEnd = offsets[cell + 1];
+        if (cellEnd - chunkBegin <= maxChunkPoints) {
+            continue;
+        }
+        
+        // 加入该单元会超过上限：先结束当前块，再把该单元中超出上限的部分拆为整块
+        const size_t cellBegin = offsets[cell];
+        if (cellBegin > chunkBegin) {
+            chunks.push_back(PointChunk{static_cast<uint32_t>(chunkBegin), static_cast<uint32_t>(cellBegin - chunkBegin)});
+            chunkBegin = cellBegin;
+        }
+        while (cellEnd - chunkBegin > maxChunkPoints) {
+            chunks.push_back(PointChunk{static_cast<uint32_t>(chunkBegin), static_cast<uint32_t>(maxChunkPoints)});
+            chunkBegin += maxChunkPoints;
+        }
+    }
+    if (chunkBegin < count) {
+        chunks.push_back(PointChunk{static_cast<uint32_t>(chunkBegin), static_cast<uint32_t>(count - chunkBegin)});
+    }
+}
+
+void shuffleWithinChunks(std::vector<uint32_t>& order, const std::vector<PointChunk>& chunks) {
+    for (const PointChunk& chunk : chunks) {
+        // 每块使用由起始位置决定的种子（xorshift的状态不能为0）
+        uint32_t state = (chunk.first * 2654435761u) | 1u;
+        uint32_t* indices = order.data() + chunk.first;
+        
+        // Fisher-Yates洗牌，用乘法把32位随机数映射到[0, i]
+        for (uint32_t i = chunk.count; i > 1; --i) {
+            const uint32_t j = static_cast<uint32_t>((static_cast<uint64_t>(nextRandom(state)) * i) >> 32);
+            std::swap(indices[i - 1], indices[j]);
+        }
+    }
+}
+
+} // namespace mviz 
\ No newline at end of file
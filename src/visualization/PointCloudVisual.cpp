@@ -1,14 +1,112 @@
 #include "visualization/PointCloudVisual.h"
 #include "rendering/Renderer.h"
+#include "rendering/StreamingBuffer.h"
+#include "rendering/UploadWorker.h"
+#include "core/Frustum.h"
+#include "visualization/PointPacking.h"
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 namespace mviz {
 
+namespace {
+
+// 着色器中的颜色模式（color_mode）
+constexpr int COLOR_MODE_RGB = 0;
+constexpr int COLOR_MODE_UNIFORM = 1;
+constexpr int COLOR_MODE_SCALAR = 2;
+constexpr int COLOR_MODE_HEIGHT = 3;
+
+// 着色器中的过滤条件（filter_flags的各位）
+constexpr int FILTER_CROP = 1;
+constexpr int FILTER_RANGE = 2;
+constexpr int FILTER_SCALAR = 4;
+constexpr int FILTER_PLANE = 8;
+
+// 量化强度的最大值
+constexpr float SCALAR_QUANTIZED_MAX = 65535.0f;
+
+// 一个属性块的字节数，按4字节对齐以便下一块的起始偏移对齐
+size_t attributeBlockBytes(size_t count) {
+    return (count * sizeof(uint16_t) + 3) / 4 * 4;
+}
+
+// 按属性的分量类型调用function(const T* values)
+template <typename Function>
+void visitAttributeData(const PointAttribute& attribute, Function&& function) {
+    switch (attribute.getType()) {
+        case AttributeType::UINT8:
+            function(attribute.data<uint8_t>());
+            break;
+        case AttributeType::UINT16:
+            function(attribute.data<uint16_t>());
+            break;
+        case AttributeType::UINT32:
+            function(attribute.data<uint32_t>());
+            break;
+        case AttributeType::INT32:
+            function(attribute.data<int32_t>());
+            break;
+        case AttributeType::FLOAT32:
+            function(attribute.data<float>());
+            break;
+        case AttributeType::FLOAT64:
+            function(attribute.data<double>());
+            break;
+    }
+}
+
+// 欧拉角（度，依次绕X、Y、Z轴）对应的旋转矩阵 R = Rz * Ry * Rx
+glm::mat3 eulerRotation(const glm::vec3& degrees) {
+    const float cx = std::cos(glm::radians(degrees.x)), sx = std::sin(glm::radians(degrees.x));
+    const float cy = std::cos(glm::radians(degrees.y)), sy = std::sin(glm::radians(degrees.y));
+    const float cz = std::cos(glm::radians(degrees.z)), sz = std::sin(glm::radians(degrees.z));
+    
+    glm::mat3 rotation(1.0f);
+    rotation[0] = glm::vec3(cy * cz, cy * sz, -sy);
+    rotation[1] = glm::vec3(sx * sy * cz - cx * sz, sx * sy * sz + cx * cz, sx * cy);
+    rotation[2] = glm::vec3(cx * sy * cz + sx * sz, cx * sy * sz - sx * cz, cx * cy);
+    return rotation;
+}
+
+} // namespace
+
 PointCloudVisual::PointCloudVisual(const std::string& name, const std::string& frame_id)
     : VisualObject(name, frame_id)
+    , m_pointSize(1.0f)
+    , m_retainCpuData(false)
+    , m_updateMode(UpdateMode::STATIC)
+    , m_positionEncoding(PositionEncoding::FLOAT32)
+    , m_colorEncoding(ColorEncoding::RGBA8)
+    , m_uniformColor(1.0f, 1.0f, 1.0f)
+    , m_colorSource(ColorSource::RGB)
+    , m_colormap(Colormap::TURBO)
+    , m_autoScalarRange(true)
+    , m_scalarMin(0.0f)
+    , m_scalarMax(1.0f)
+    , m_drawnScalarMin(0.0f)
+    , m_drawnScalarMax(1.0f)
+    , m_heightAxis(0.0f, 1.0f, 0.0f)
+    , m_cropInverseRotation(1.0f)
+    , m_cropMin(-1.0f)
+    , m_cropMax(1.0f)
+    , m_frustumCulling(true)
+    , m_drawnPointCount(0)
+    , m_pointBudget(0)
+    , m_sliceBegin(0.0)
+    , m_sliceEnd(1.0)
+    , m_revision(0)
     , m_vao(0)
     , m_vbo(0)
+    , m_vaoBuffer(0)
+    , m_vaoBase(0)
+    , m_accumulationBuffer(0)
+    , m_slotCapacity(0)
+    , m_nextSlot(0)
+    , m_decayTime(0.0f)
+    , m_timeOrigin(std::chrono::steady_clock::now())
     , m_needBufferUpdate(true)
     , m_pointCount(0)
 {
@@ -22,32 +120,185 @@ PointCloudVisual::~PointCloudVisual() {
 }
 
 void PointCloudVisual::setPointCloud(const PointCloudData& pointCloud) {
+    setPointCloud(std::make_shared<const PointCloudData>(pointCloud));
+}
+
+void PointCloudVisual::setPointCloud(PointCloudData&& pointCloud) {
+    setPointCloud(std::make_shared<const PointCloudData>(std::move(pointCloud)));
+}
+
+void PointCloudVisual::setPointCloud(std::shared_ptr<const PointCloudData> pointCloud) {
     // 更新点云数据
-    m_pointCloudData = pointCloud;
+    m_pointCloud = std::move(pointCloud);
+    m_pointSize = m_pointCloud ? m_pointCloud->pointSize : m_pointSize;
+    m_stamp = m_pointCloud ? m_pointCloud->stamp : 0.0;
     m_needBufferUpdate = true;
+    
+    // 记录会上传的标量属性，供界面选择颜色来源和过滤条件
+    if (m_pointCloud) {
+        m_attributeNames.clear();
+        for (const PointAttribute& attribute : m_pointCloud->attributes) {
+            if (isShaderAttribute(attribute)) {
+                m_attributeNames.push_back(attribute.getName());
+            }
+        }
+    }
+    
+    // 局部修改针对的是之前的点云
+    m_positionEdits.clear();
+    m_colorEdits.clear();
 }
 
 void PointCloudVisual::setPointSize(float size) {
     // 更新点的大小
-    if (size > 0) {
-        m_pointCloudData.pointSize = size;
+    if (size > 0 && size != m_pointSize) {
+        m_pointSize = size;
+        ++m_revision;
     }
 }
 
-void PointCloudVisual::update(TFManager& tf_manager, const std::string& reference_frame) {
-    // 调用基类的update方法更新模型矩阵
-    VisualObject::update(tf_manager, reference_frame);
+void PointCloudVisual::setUniformColor(const glm::vec3& color) {
+    if (color != m_uniformColor) {
+        m_uniformColor = color;
+        ++m_revision;
+    }
+}
+
+void PointCloudVisual::setColorSource(ColorSource source) {
+    if (source != m_colorSource) {
+        m_colorSource = source;
+        ++m_revision;
+    }
+}
+
+bool PointCloudVisual::hasColorSource(ColorSource source) const {
+    const char* name = sourceAttribute(source);
+    return !name || std::find(m_attributeNames.begin(), m_attributeNames.end(), name) != m_attributeNames.end();
+}
+
+void PointCloudVisual::setColormap(Colormap colormap) {
+    if (colormap != m_colormap) {
+        m_colormap = colormap;
+        ++m_revision;
+    }
+}
+
+void PointCloudVisual::setScalarRange(float min, float max) {
+    m_autoScalarRange = false;
+    m_scalarMin = m_drawnScalarMin = min;
+    m_scalarMax = m_drawnScalarMax = max;
+    ++m_revision;
+}
+
+void PointCloudVisual::getScalarRange(float& min, float& max) const {
+    min = m_drawnScalarMin;
+    max = m_drawnScalarMax;
+}
+
+void PointCloudVisual::setAutoScalarRange(bool autoRange) {
+    if (autoRange == m_autoScalarRange) {
+        return;
+    }
     
-    // 如果需要，更新缓冲区
-    if (m_needBufferUpdate) {
-        updateBuffers();
+    // 关闭时从当前的自动范围开始手动调整
+    m_autoScalarRange = autoRange;
+    if (!autoRange) {
+        m_scalarMin = m_drawnScalarMin;
+        m_scalarMax = m_drawnScalarMax;
+    }
+    ++m_revision;
+}
+
+void PointCloudVisual::setHeightAxis(const glm::vec3& axis) {
+    const float length = glm::length(axis);
+    if (length > 0.0f) {
+        m_heightAxis = axis * (1.0f / length);
+        ++m_revision;
+    }
+}
+
+void PointCloudVisual::setFilter(const PointFilter& filter) {
+    m_filter = filter;
+    
+    // 裁剪框的包围盒：每个轴上的半径为各边在该轴上投影长度之和
+    const glm::mat3 rotation = eulerRotation(filter.cropRotation);
+    glm::vec3 extent(0.0f);
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int edge = 0; edge < 3; ++edge) {
+            extent[axis] += std::abs(rotation[edge][axis]) * filter.cropHalfSize[edge];
+        }
+    }
+    m_cropInverseRotation = glm::transpose(rotation);
+    m_cropMin = filter.cropCenter - extent;
+    m_cropMax = filter.cropCenter + extent;
+    ++m_revision;
+}
+
+void PointCloudVisual::setDrawSlice(double begin, double end) {
+    m_sliceBegin = std::clamp(begin, 0.0, 1.0);
+    m_sliceEnd = std::clamp(end, m_sliceBegin, 1.0);
+}
+
+void PointCloudVisual::setPositionEncoding(PositionEncoding encoding) {
+    if (encoding != m_positionEncoding) {
+        m_positionEncoding = encoding;
+        m_needBufferUpdate = m_needBufferUpdate || m_pointCloud != nullptr;
+    }
+}
+
+void PointCloudVisual::setColorEncoding(ColorEncoding encoding) {
+    if (encoding != m_colorEncoding) {
+        m_colorEncoding = encoding;
+        m_needBufferUpdate = m_needBufferUpdate || m_pointCloud != nullptr;
+    }
+}
+
+bool PointCloudVisual::updatePositions(size_t first, const std::vector<glm::vec3>& positions) {
+    return addRangeEdit(m_positionEdits, first, positions);
+}
+
+bool PointCloudVisual::updateColors(size_t first, const std::vector<glm::vec3>& colors) {
+    if (m_colorEncoding == ColorEncoding::UNIFORM) {
+        return false;
+    }
+    return addRangeEdit(m_colorEdits, first, colors);
+}
+
+void PointCloudVisual::setAccumulation(size_t maxScans, float decayTime) {
+    m_decayTime = std::max(decayTime, 0.0f);
+    if (maxScans == m_slots.size()) {
+        return;
+    }
+    
+    // 槽位数改变时丢弃已累积的扫描
+    releaseAccumulation();
+    m_slots.resize(maxScans);
+}
+
+void PointCloudVisual::updateResources() {
+    // 整个点云被剔除时本帧不会调用draw()
+    m_drawnPointCount = 0;
+    
+    // 后台上传完成后切换到新的缓冲区
+    if (m_pendingUpload && m_pendingUpload->ticket->isComplete()) {
+        finishAsyncUpload();
+    }
+    
+    // 如果需要，更新缓冲区；后台上传进行中时等它完成后再提交最新的点云
+    if (m_needBufferUpdate && !m_pendingUpload) {
         m_needBufferUpdate = false;
+        updateBuffers();
+    }
+    
+    // 局部修改作用于最新的点云，等完整上传结束后再上传
+    if (!m_needBufferUpdate && !m_pendingUpload && (!m_positionEdits.empty() || !m_colorEdits.empty())) {
+        flushRangeEdits();
     }
 }
 
 void PointCloudVisual::draw(Renderer& renderer, const glm::mat4& view_projection_matrix) {
     // 如果不可见或者没有点，则不绘制
-    if (!m_visible || m_pointCount == 0) {
+    if (!m_visible || (m_slots.empty() && m_pointCount == 0)) {
         return;
     }
     
@@ -68,89 +319,1041 @@ void PointCloudVisual::draw(Renderer& renderer, const glm::mat4& view_projection
     shader->use();
     
     // 设置着色器统一变量
-    shader->setMat4("model", m_model_matrix);
     shader->setMat4("view_projection", view_projection_matrix);
-    shader->setFloat("point_size", m_pointCloudData.pointSize);
+    shader->setFloat("point_size", m_pointSize);
+    shader->setVec3("uniform_color", m_uniformColor);
     
-    // 绑定VAO并绘制点
-    glBindVertexArray(m_vao);
-    glDrawArrays(GL_POINTS, 0, m_pointCount);
-    glBindVertexArray(0);
+    if (!m_slots.empty()) {
+        // 累积模式：逐个绘制未过期的槽位，着色器按写入时间淡出
+        const double now = currentTime();
+        shader->setFloat("current_time", static_cast<float>(now));
+        shader->setFloat("decay_time", m_decayTime);
+        
+        // 各帧的模型矩阵不同，按参考坐标系中的视锥体逐帧剔除
+        const Frustum frustum = Frustum::fromMatrix(view_projection_matrix);
+        std::vector<ScanSlot*> visibleSlots;
+        size_t visiblePoints = 0;
+        for (ScanSlot& slot : m_slots) {
+            if (slot.layout.count == 0 || (m_decayTime > 0.0f && now - slot.time >= m_decayTime)) {
+                continue;
+            }
+            
+            glm::vec3 min, max;
+            transformBox(slot.model, slot.layout.min, slot.layout.max, min, max);
+            if (frustum.intersectsBox(min, max) && filterMayPass(slot.layout.min, slot.layout.max)) {
+                visibleSlots.push_back(&slot);
+                visiblePoints += slot.layout.count;
+            }
+        }
+        
+        // 自动范围取各帧范围的并集，使同一个值在各帧中颜色相同
+        if (m_autoScalarRange) {
+            bool found = false;
+            for (const ScanSlot* slot : visibleSlots) {
+                float min, max;
+                if (computeScalarRange(slot->layout, slot->model, min, max)) {
+                    m_drawnScalarMin = found ? std::min(m_drawnScalarMin, min) : min;
+                    m_drawnScalarMax = found ? std::max(m_drawnScalarMax, max) : max;
+                    found = true;
+                }
+            }
+        }
+        
+        // 预算按点数比例分给各帧，累计取整使总数不超过预算
+        const bool limited = m_pointBudget > 0 && visiblePoints > m_pointBudget;
+        size_t cumulative = 0;
+        size_t allotted = 0;
+        m_drawnPointCount = 0;
+        for (ScanSlot* slot : visibleSlots) {
+            size_t budget = 0;
+            if (limited) {
+                cumulative += slot->layout.count;
+                const size_t end = static_cast<size_t>(static_cast<double>(cumulative) * m_pointBudget / visiblePoints);
+                budget = end - allotted;
+                allotted = end;
+                if (budget == 0) {
+                    continue;
+                }
+            }
+            
+            const VaoBinding target = attributeBinding(slot->layout);
+            shader->setMat4("model", slot->model);
+            shader->setVec3("position_scale", slot->layout.scale);
+            shader->setVec3("position_offset", slot->layout.offset);
+            shader->setFloat("scan_time", static_cast<float>(slot->time));
+            setColorUniforms(*shader, renderer, slot->layout, target.channel);
+            setFilterUniforms(*shader, slot->layout, target.filterChannel);
+            
+            m_drawnPointCount += drawStrided(slot->vao, m_accumulationBuffer, slot->base, slot->layout, slot->binding,
+                                             target, budget);
+        }
+        glBindVertexArray(0);
+    } else {
+        const VaoBinding target = attributeBinding(m_layout);
+        if (m_autoScalarRange) {
+            computeScalarRange(m_layout, m_model_matrix, m_drawnScalarMin, m_drawnScalarMax);
+        }
+        
+        shader->setMat4("model", m_model_matrix);
+        shader->setVec3("position_scale", m_layout.scale);
+        shader->setVec3("position_offset", m_layout.offset);
+        shader->setFloat("decay_time", 0.0f);
+        setColorUniforms(*shader, renderer, m_layout, target.channel);
+        setFilterUniforms(*shader, m_layout, target.filterChannel);
+        
+        // 绑定VAO并绘制点
+        if (!filterMayPass(m_layout.min, m_layout.max)) {
+            m_drawnPointCount = 0;
+        } else if (m_chunkIndex.chunks.empty()) {
+            m_drawnPointCount = drawStrided(m_vao, m_vaoBuffer, m_vaoBase, m_layout, m_vaoBinding, target, m_pointBudget);
+        } else {
+            updateBinding(m_vao, m_vaoBuffer, m_vaoBase, m_layout, m_vaoBinding, target);
+            glBindVertexArray(m_vao);
+            drawChunks(view_projection_matrix);
+        }
+        glBindVertexArray(0);
+    }
+    
+    // 流式缓冲区的当前段在本次绘制完成前不能被覆盖
+    if (m_streamingBuffer) {
+        m_streamingBuffer->fence();
+    }
     
     // 恢复到基本着色器
     renderer.useShader(Renderer::ShaderType::BASIC);
 }
 
+bool PointCloudVisual::getLocalBounds(glm::vec3& min, glm::vec3& max) const {
+    if (!m_slots.empty() || m_pointCount == 0) {
+        return false;
+    }
+    
+    min = m_layout.min;
+    max = m_layout.max;
+    return true;
+}
+
+size_t PointCloudVisual::getDrawablePointCount() const {
+    if (m_slots.empty()) {
+        return m_pointCount;
+    }
+    
+    const double now = currentTime();
+    size_t count = 0;
+    for (const ScanSlot& slot : m_slots) {
+        if (m_decayTime <= 0.0f || now - slot.time < m_decayTime) {
+            count += slot.layout.count;
+        }
+    }
+    return count;
+}
+
+void PointCloudVisual::drawChunks(const glm::mat4& view_projection_matrix) {
+    // 从包含模型矩阵的裁剪矩阵中提取平面，直接检测点云坐标系中的包围盒
+    const Frustum frustum = Frustum::fromMatrix(view_projection_matrix * m_model_matrix);
+    
+    m_drawFirsts.clear();
+    m_drawCounts.clear();
+    size_t visiblePoints = 0;
+    for (const PointChunk& chunk : m_chunkIndex.chunks) {
+        if (frustum.intersectsBox(chunk.min, chunk.max) && filterMayPass(chunk.min, chunk.max)) {
+            m_drawFirsts.push_back(static_cast<GLint>(chunk.first));
+            m_drawCounts.push_back(static_cast<GLsizei>(chunk.count));
+            visiblePoints += chunk.count;
+        }
+    }
+    
+    if (m_sliceBegin > 0.0 || m_sliceEnd < 1.0) {
+        // 分段绘制：每块的[begin, end)比例范围
+        m_drawnPointCount = 0;
+        for (size_t i = 0; i < m_drawFirsts.size(); ++i) {
+            const GLsizei count = m_drawCounts[i];
+            const GLsizei begin = static_cast<GLsizei>(count * m_sliceBegin);
+            const GLsizei end = static_cast<GLsizei>(count * m_sliceEnd);
+            m_drawFirsts[i] += begin;
+            m_drawCounts[i] = end - begin;
+            m_drawnPointCount += end - begin;
+        }
+    } else if (m_pointBudget > 0 && visiblePoints > m_pointBudget) {
+        // 块内的点已被打乱，每块的前缀是该块的随机子样本；累计取整使总数恰好等于预算
+        size_t cumulative = 0;
+        size_t drawn = 0;
+        for (GLsizei& count : m_drawCounts) {
+            cumulative += count;
+            const size_t end = static_cast<size_t>(static_cast<double>(cumulative) * m_pointBudget / visiblePoints);
+            count = static_cast<GLsizei>(end - drawn);
+            drawn = end;
+        }
+        m_drawnPointCount = drawn;
+    } else {
+        // 与上一段相邻时合并，减少驱动处理的段数
+        size_t runs = 0;
+        for (size_t i = 0; i < m_drawFirsts.size(); ++i) {
+            if (runs > 0 && m_drawFirsts[runs - 1] + m_drawCounts[runs - 1] == m_drawFirsts[i]) {
+                m_drawCounts[runs - 1] += m_drawCounts[i];
+            } else {
+                m_drawFirsts[runs] = m_drawFirsts[i];
+                m_drawCounts[runs] = m_drawCounts[i];
+                ++runs;
+            }
+        }
+        m_drawFirsts.resize(runs);
+        m_drawCounts.resize(runs);
+        m_drawnPointCount = visiblePoints;
+    }
+    
+    if (!m_drawFirsts.empty()) {
+        glMultiDrawArrays(GL_POINTS, m_drawFirsts.data(), m_drawCounts.data(), static_cast<GLsizei>(m_drawFirsts.size()));
+    }
+}
+
+size_t PointCloudVisual::drawStrided(GLuint vao, GLuint buffer, size_t base, const VertexLayout& layout,
+                                     VaoBinding& binding, VaoBinding target, size_t budget) {
+    // 间隔受顶点属性步长限制（OpenGL 4.4起保证至少支持2048字节）
+    constexpr size_t MAX_ATTRIBUTE_STRIDE = 2048;
+    // 间隔达到上限后仍超出预算时，分成的均匀分布的段数
+    constexpr size_t MAX_STRIDED_RUNS = 1024;
+    
+    target.step = 1;
+    if (budget > 0 && layout.count > budget) {
+        target.step = std::min((layout.count + budget - 1) / budget, MAX_ATTRIBUTE_STRIDE / layout.positionStride);
+    }
+    updateBinding(vao, buffer, base, layout, binding, target);
+    glBindVertexArray(vao);
+    
+    const size_t count = (layout.count + target.step - 1) / target.step;
+    if (budget == 0 || count <= budget) {
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(count));
+        return count;
+    }
+    
+    // 间隔已达上限：把按间隔取出的点均分为若干段，每段只绘制前缀，使绘制的点分布在整个点云上而不是集中在开头
+    // 各段长度按累计取整，不超过到下一段起点的距离
+    const size_t runs = std::min(budget, MAX_STRIDED_RUNS);
+    m_drawFirsts.resize(runs);
+    m_drawCounts.resize(runs);
+    size_t drawn = 0;
+    for (size_t i = 0; i < runs; ++i) {
+        const size_t first = i * count / runs;
+        const size_t next = (i + 1) * count / runs;
+        const size_t length = std::min((i + 1) * budget / runs - i * budget / runs, next - first);
+        m_drawFirsts[i] = static_cast<GLint>(first);
+        m_drawCounts[i] = static_cast<GLsizei>(length);
+        drawn += length;
+    }
+    glMultiDrawArrays(GL_POINTS, m_drawFirsts.data(), m_drawCounts.data(), static_cast<GLsizei>(runs));
+    return drawn;
+}
+
+const char* PointCloudVisual::sourceAttribute(ColorSource source) {
+    switch (source) {
+        case ColorSource::INTENSITY:
+            return ATTRIBUTE_INTENSITY;
+        case ColorSource::RING:
+            return ATTRIBUTE_RING;
+        case ColorSource::LABEL:
+            return ATTRIBUTE_LABEL;
+        default:
+            return nullptr;
+    }
+}
+
+const char* PointCloudVisual::filterAttribute() const {
+    return m_filter.scalarEnabled ? sourceAttribute(m_filter.scalarSource) : nullptr;
+}
+
+int PointCloudVisual::scalarChannel(const VertexLayout& layout) const {
+    const char* name = sourceAttribute(m_colorSource);
+    return name ? layout.findAttribute(name) : -1;
+}
+
+int PointCloudVisual::filterChannel(const VertexLayout& layout) const {
+    const char* name = filterAttribute();
+    return name ? layout.findAttribute(name) : -1;
+}
+
+bool PointCloudVisual::isShaderAttribute(const PointAttribute& attribute) {
+    if (attribute.getComponents() != 1 || attribute.empty()) {
+        return false;
+    }
+    for (ColorSource source : {ColorSource::INTENSITY, ColorSource::RING, ColorSource::LABEL}) {
+        if (attribute.getName() == sourceAttribute(source)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PointCloudVisual::VaoBinding PointCloudVisual::attributeBinding(const VertexLayout& layout) const {
+    VaoBinding binding;
+    binding.channel = scalarChannel(layout);
+    binding.filterChannel = filterChannel(layout);
+    return binding;
+}
+
+bool PointCloudVisual::filterMayPass(const glm::vec3& min, const glm::vec3& max) const {
+    if (m_filter.cropEnabled) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (max[axis] < m_cropMin[axis] || min[axis] > m_cropMax[axis]) {
+                return false;
+            }
+        }
+    }
+    
+    if (m_filter.rangeEnabled) {
+        // 包围盒到原点的最近和最远距离
+        float nearest = 0.0f;
+        float farthest = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            const float closest = std::max({min[axis], -max[axis], 0.0f});
+            const float furthest = std::max(std::abs(min[axis]), std::abs(max[axis]));
+            nearest += closest * closest;
+            farthest += furthest * furthest;
+        }
+        if (nearest > m_filter.maxRange * m_filter.maxRange || farthest < m_filter.minRange * m_filter.minRange) {
+            return false;
+        }
+    }
+    
+    if (m_filter.planeEnabled) {
+        // 包围盒在法向上最靠前的角
+        float distance = m_filter.planeOffset;
+        for (int axis = 0; axis < 3; ++axis) {
+            const float n = m_filter.planeNormal[axis];
+            distance += n * (n >= 0.0f ? max[axis] : min[axis]);
+        }
+        if (distance < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PointCloudVisual::computeScalarRange(const VertexLayout& layout, const glm::mat4& model, float& min,
+                                          float& max) const {
+    if (m_colorSource == ColorSource::HEIGHT) {
+        if (layout.count == 0) {
+            return false;
+        }
+        
+        // 包围盒在高度轴上的投影：每个分量按高度轴的符号取较小或较大的一端
+        glm::vec3 boxMin, boxMax;
+        transformBox(model, layout.min, layout.max, boxMin, boxMax);
+        min = max = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            const float a = m_heightAxis[axis];
+            min += a * (a >= 0.0f ? boxMin[axis] : boxMax[axis]);
+            max += a * (a >= 0.0f ? boxMax[axis] : boxMin[axis]);
+        }
+        return true;
+    }
+    
+    const int channel = scalarChannel(layout);
+    if (channel < 0) {
+        return false;
+    }
+    min = layout.attributes[channel].min;
+    max = layout.attributes[channel].max;
+    return true;
+}
+
+void PointCloudVisual::setColorUniforms(Shader& shader, Renderer& renderer, const VertexLayout& layout,
+                                        int channel) const {
+    // 所选的标量属性不存在时按RGB着色
+    int mode = layout.hasColors ? COLOR_MODE_RGB : COLOR_MODE_UNIFORM;
+    if (m_colorSource == ColorSource::HEIGHT) {
+        mode = COLOR_MODE_HEIGHT;
+    } else if (channel >= 0) {
+        mode = COLOR_MODE_SCALAR;
+    }
+    shader.setInt("color_mode", mode);
+    if (mode != COLOR_MODE_SCALAR && mode != COLOR_MODE_HEIGHT) {
+        return;
+    }
+    
+    if (channel >= 0) {
+        shader.setFloat("scalar_scale", layout.attributes[channel].scale);
+        shader.setFloat("scalar_bias", layout.attributes[channel].bias);
+    }
+    shader.setFloat("scalar_min", m_drawnScalarMin);
+    shader.setFloat("scalar_max", m_drawnScalarMax);
+    shader.setVec3("height_axis", m_heightAxis);
+    shader.setBool("colormap_discrete", isDiscreteColormap(m_colormap));
+    
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_1D, renderer.getColormapTexture(m_colormap));
+    shader.setInt("colormap", 0);
+}
+
+void PointCloudVisual::setFilterUniforms(Shader& shader, const VertexLayout& layout, int filterChannel) const {
+    int flags = 0;
+    if (m_filter.cropEnabled) {
+        flags |= FILTER_CROP;
+        shader.setMat3("crop_inverse_rotation", m_cropInverseRotation);
+        shader.setVec3("crop_center", m_filter.cropCenter);
+        shader.setVec3("crop_half_size", m_filter.cropHalfSize);
+    }
+    if (m_filter.rangeEnabled) {
+        flags |= FILTER_RANGE;
+        shader.setVec2("filter_range", glm::vec2(m_filter.minRange, m_filter.maxRange));
+    }
+    if (filterChannel >= 0) {
+        flags |= FILTER_SCALAR;
+        shader.setFloat("filter_scalar_scale", layout.attributes[filterChannel].scale);
+        shader.setFloat("filter_scalar_bias", layout.attributes[filterChannel].bias);
+        shader.setVec2("filter_scalar_range", glm::vec2(m_filter.scalarMin, m_filter.scalarMax));
+    }
+    if (m_filter.planeEnabled) {
+        flags |= FILTER_PLANE;
+        shader.setVec4("clip_plane", glm::vec4(m_filter.planeNormal, m_filter.planeOffset));
+    }
+    shader.setInt("filter_flags", flags);
+}
+
+size_t PointCloudVisual::editablePointCount() const {
+    if (m_needBufferUpdate && m_pointCloud) {
+        return m_pointCloud->size();
+    }
+    if (m_pendingUpload) {
+        return m_pendingUpload->layout.count;
+    }
+    return m_pointCount;
+}
+
+bool PointCloudVisual::addRangeEdit(std::vector<RangeEdit>& edits, size_t first,
+                                    const std::vector<glm::vec3>& values) {
+    // 流式和累积模式下的数据位于每帧轮换的缓冲区中，不支持局部修改
+    if (m_updateMode == UpdateMode::STREAMING || !m_slots.empty()) {
+        return false;
+    }
+    if (first > editablePointCount() || values.size() > editablePointCount() - first) {
+        return false;
+    }
+    
+    if (!values.empty()) {
+        edits.push_back(RangeEdit{first, values});
+    }
+    return true;
+}
+
+std::vector<PointCloudVisual::RangeEdit> PointCloudVisual::coalesceRangeEdits(const std::vector<RangeEdit>& edits) {
+    // 按起始下标排序后合并重叠或相邻的范围
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (const RangeEdit& edit : edits) {
+        ranges.emplace_back(edit.first, edit.first + edit.values.size());
+    }
+    std::sort(ranges.begin(), ranges.end());
+    
+    std::vector<RangeEdit> merged;
+    for (const auto& [begin, end] : ranges) {
+        if (!merged.empty() && begin <= merged.back().first + merged.back().values.size()) {
+            RangeEdit& last = merged.back();
+            last.values.resize(std::max(last.values.size(), end - last.first));
+        } else {
+            merged.push_back(RangeEdit{begin, std::vector<glm::vec3>(end - begin)});
+        }
+    }
+    
+    // 按提交顺序写入，后提交的修改覆盖先提交的
+    for (const RangeEdit& edit : edits) {
+        auto it = std::upper_bound(merged.begin(), merged.end(), edit.first,
+                                   [](size_t first, const RangeEdit& range) { return first < range.first; });
+        RangeEdit& range = *(it - 1);
+        std::copy(edit.values.begin(), edit.values.end(), range.values.begin() + (edit.first - range.first));
+    }
+    
+    return merged;
+}
+
+void PointCloudVisual::flushRangeEdits() {
+    const std::vector<RangeEdit> positions = coalesceRangeEdits(m_positionEdits);
+    const std::vector<RangeEdit> colors = m_layout.hasColors ? coalesceRangeEdits(m_colorEdits) : std::vector<RangeEdit>();
+    m_positionEdits.clear();
+    m_colorEdits.clear();
+    
+    // 点云为空或上传失败时没有可修改的数据
+    if (m_pointCount == 0) {
+        return;
+    }
+    
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    
+    const std::vector<uint32_t>& packedIndex = m_chunkIndex.packedIndex;
+    if (packedIndex.empty()) {
+        // 点未重排：合并后的每个范围在缓冲区中同样连续
+        for (const RangeEdit& range : positions) {
+            if (range.first + range.values.size() > m_pointCount) continue;
+            uploadPositions(range.first, range.values.data(), range.values.size());
+            growBounds(range.first, range.values.data(), range.values.size());
+        }
+        for (const RangeEdit& range : colors) {
+            if (range.first + range.values.size() > m_pointCount) continue;
+            uploadColors(range.first, range.values.data(), range.values.size());
+        }
+    } else {
+        // 点已分块重排：换算为缓冲区中的位置后排序，按其中连续的段上传
+        auto upload = [&](const std::vector<RangeEdit>& ranges, bool isPosition) {
+            std::vector<std::pair<uint32_t, glm::vec3>> packed;
+            for (const RangeEdit& range : ranges) {
+                if (range.first + range.values.size() > m_pointCount) continue;
+                for (size_t i = 0; i < range.values.size(); ++i) {
+                    packed.emplace_back(packedIndex[range.first + i], range.values[i]);
+                }
+            }
+            std::sort(packed.begin(), packed.end(),
+                      [](const auto& a, const auto& b) { return a.first < b.first; });
+            
+            std::vector<glm::vec3> run;
+            for (size_t begin = 0, end = 0; begin < packed.size(); begin = end) {
+                run.clear();
+                for (end = begin; end < packed.size() && packed[end].first == packed[begin].first + (end - begin); ++end) {
+                    run.push_back(packed[end].second);
+                }
+                if (isPosition) {
+                    uploadPositions(packed[begin].first, run.data(), run.size());
+                    growBounds(packed[begin].first, run.data(), run.size());
+                } else {
+                    uploadColors(packed[begin].first, run.data(), run.size());
+                }
+            }
+        };
+        upload(positions, true);
+        upload(colors, false);
+    }
+    
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    ++m_revision;
+}
+
+void PointCloudVisual::uploadPositions(size_t first, const glm::vec3* positions, size_t count) {
+    const size_t offset = first * m_layout.positionStride;
+    if (m_layout.quantized) {
+        std::vector<int16_t> quantized(4 * count);
+        quantizePositions(positions, count, m_layout.scale, m_layout.offset, quantized.data());
+        glBufferSubData(GL_ARRAY_BUFFER, offset, quantized.size() * sizeof(int16_t), quantized.data());
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, count * sizeof(glm::vec3), positions);
+    }
+}
+
+void PointCloudVisual::uploadColors(size_t first, const glm::vec3* colors, size_t count) {
+    std::vector<uint32_t> packed(count);
+    packColorsRGBA8(colors, count, packed.data());
+    glBufferSubData(GL_ARRAY_BUFFER, m_layout.positionBytes + first * sizeof(uint32_t),
+                    packed.size() * sizeof(uint32_t), packed.data());
+}
+
+void PointCloudVisual::growBounds(size_t first, const glm::vec3* positions, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    
+    // 包围盒只扩大不缩小，保证剔除不会丢掉移动过的点；全部为无效点时保持原来的包围盒
+    glm::vec3 min = m_layout.min;
+    glm::vec3 max = m_layout.max;
+    computePointBounds(positions, count, min, max);
+    m_layout.min = glm::min(m_layout.min, min);
+    m_layout.max = glm::max(m_layout.max, max);
+    
+    std::vector<PointChunk>& chunks = m_chunkIndex.chunks;
+    if (chunks.empty()) {
+        return;
+    }
+    auto it = std::upper_bound(chunks.begin(), chunks.end(), first,
+                               [](size_t index, const PointChunk& chunk) { return index < chunk.first; });
+    for (--it; it != chunks.end() && it->first < first + count; ++it) {
+        const size_t begin = std::max<size_t>(it->first, first);
+        const size_t end = std::min<size_t>(it->first + it->count, first + count);
+        min = it->min;
+        max = it->max;
+        computePointBounds(positions + (begin - first), end - begin, min, max);
+        it->min = glm::min(it->min, min);
+        it->max = glm::max(it->max, max);
+    }
+}
+
 void PointCloudVisual::initializeGLResources() {
     // 创建VAO和VBO
     glGenVertexArrays(1, &m_vao);
     glGenBuffers(1, &m_vbo);
     
+    // 顶点属性的格式和颜色块的偏移取决于编码方式和点数，在updateBuffers()中设置
+}
+
+void PointCloudVisual::updateBuffers() {
+    // 如果没有点，则不更新
+    if (!m_pointCloud || m_pointCloud->empty()) {
+        m_pointCount = 0;
+        m_pointCloud.reset();
+        return;
+    }
+    
+    if (!m_slots.empty()) {
+        accumulateScan();
+        return;
+    }
+    
+    if (m_updateMode == UpdateMode::ASYNC && m_uploadWorker) {
+        submitAsyncUpload();
+        return;
+    }
+    
+    VertexLayout layout = computeLayout(*m_pointCloud);
+    const bool streaming = m_updateMode == UpdateMode::STREAMING;
+    if (!streaming) {
+        m_streamingBuffer.reset();
+    } else if (!m_streamingBuffer) {
+        m_streamingBuffer = std::make_unique<StreamingBuffer>();
+    }
+    
     // 绑定VAO
     glBindVertexArray(m_vao);
     
-    // 绑定VBO
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    // 直接把转换结果写入映射的缓冲区，不经过CPU端的中间数组
+    // STREAMING：写入环形缓冲区的下一段，不等待GPU；STATIC：重新分配存储
+    uint8_t* mapped = nullptr;
+    size_t base = 0;
+    if (streaming) {
+        mapped = static_cast<uint8_t*>(m_streamingBuffer->beginWrite(layout.totalBytes(), base));
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, layout.totalBytes(), nullptr, GL_STATIC_DRAW);
+        mapped = static_cast<uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, layout.totalBytes(),
+                                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    }
+    if (!mapped) {
+        std::cerr << "Error: Failed to map point cloud buffer" << std::endl;
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+        m_pointCount = 0;
+        return;
+    }
     
-    // 设置顶点属性
-    // 顶点位置: vec3
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    // 流式模式每帧重新上传，不值得为剔除重排
+    ChunkIndex chunkIndex;
+    writeVertices(*m_pointCloud, layout, mapped, !streaming && m_frustumCulling ? &chunkIndex : nullptr);
     
-    // 顶点颜色: vec3
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+    // 映射期间缓冲区内容可能丢失（如显示模式切换），此时保留数据下一帧重试
+    if (!(streaming ? m_streamingBuffer->endWrite() : glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE)) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+        m_pointCount = 0;
+        m_needBufferUpdate = true;
+        return;
+    }
     
-    // 解绑VAO和VBO
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
+    applyLayout(streaming ? m_streamingBuffer->getBuffer() : m_vbo, base, layout, std::move(chunkIndex));
+    
+    // 数据已在GPU上，释放对CPU端数据的引用（其他持有者不受影响）
+    if (!m_retainCpuData) {
+        m_pointCloud.reset();
+    }
 }
 
-void PointCloudVisual::updateBuffers() {
-    // 如果没有点，则不更新
-    if (m_pointCloudData.empty()) {
-        m_pointCount = 0;
-        return;
+PointCloudVisual::VertexLayout PointCloudVisual::computeLayout(const PointCloudData& pointCloud) const {
+    VertexLayout layout;
+    layout.count = pointCloud.points.size();
+    layout.quantized = m_positionEncoding == PositionEncoding::INT16;
+    layout.hasColors = m_colorEncoding == ColorEncoding::RGBA8 && !pointCloud.colors.empty();
+    layout.positionStride = layout.quantized ? 4 * sizeof(int16_t) : sizeof(glm::vec3);
+    layout.positionBytes = layout.count * layout.positionStride;
+    layout.colorBytes = layout.hasColors ? layout.count * sizeof(uint32_t) : 0;
+    
+    // 上传着色器能读取的所有标量属性，切换颜色来源和过滤条件只改变顶点属性绑定；其他通道（如时间戳、法向量）留在CPU端
+    size_t offset = layout.positionBytes + layout.colorBytes;
+    for (const PointAttribute& attribute : pointCloud.attributes) {
+        if (!isShaderAttribute(attribute) || layout.findAttribute(attribute.getName().c_str()) >= 0) {
+            continue;
+        }
+        
+        AttributeBlock block;
+        block.name = attribute.getName();
+        block.offset = offset;
+        layout.attributes.push_back(std::move(block));
+        offset += attributeBlockBytes(layout.count);
     }
+    layout.attributeBytes = offset - layout.positionBytes - layout.colorBytes;
+    return layout;
+}
+
+void PointCloudVisual::writeVertices(const PointCloudData& pointCloud, VertexLayout& layout, uint8_t* dst,
+                                     ChunkIndex* chunkIndex) {
+    const std::vector<glm::vec3>& points = pointCloud.points;
+    const std::vector<glm::vec3>& colors = pointCloud.colors;
     
-    // 确保颜色数组和点数组大小一致
-    if (m_pointCloudData.colors.size() < m_pointCloudData.points.size()) {
-        // 如果颜色不足，使用默认颜色（白色）填充
-        m_pointCloudData.colors.resize(m_pointCloudData.points.size(), glm::vec3(1.0f, 1.0f, 1.0f));
+    computePointBounds(points.data(), layout.count, layout.min, layout.max);
+    if (layout.quantized) {
+        computeQuantization(layout.min, layout.max, layout.scale, layout.offset);
     }
+    prepareAttributes(pointCloud, layout);
     
-    // 创建顶点数据数组（位置+颜色）
-    std::vector<float> vertices;
-    vertices.reserve(m_pointCloudData.points.size() * 6); // 每个点6个浮点数：xyz位置和rgb颜色
+    if (!chunkIndex) {
+        if (layout.quantized) {
+            quantizePositions(points.data(), layout.count, layout.scale, layout.offset, reinterpret_cast<int16_t*>(dst));
+        } else {
+            std::memcpy(dst, points.data(), layout.positionBytes);
+        }
+        
+        if (layout.hasColors) {
+            const size_t colorCount = std::min(colors.size(), layout.count);
+            uint32_t* packed = reinterpret_cast<uint32_t*>(dst + layout.positionBytes);
+            packColorsRGBA8(colors.data(), colorCount, packed);
+            
+            // 如果颜色不足，剩余的点使用默认颜色（白色）
+            std::fill(packed + colorCount, packed + layout.count, 0xFFFFFFFFu);
+        }
+        writeAttributes(pointCloud, layout, dst, nullptr, 0, layout.count);
+        return;
+    }
     
-    for (size_t i = 0; i < m_pointCloudData.points.size(); ++i) {
-        // 添加位置
-        vertices.push_back(m_pointCloudData.points[i].x);
-        vertices.push_back(m_pointCloudData.points[i].y);
-        vertices.push_back(m_pointCloudData.points[i].z);
+    // 分块重排：逐块把点收集到临时数组中，求出块的包围盒后打包写入该块在缓冲区中的位置
+    // 块内打乱后，按预算降采样时只需绘制每块的前缀
+    std::vector<uint32_t> order;
+    buildPointChunks(points.data(), layout.count, layout.min, layout.max, MAX_CHUNK_POINTS, order,
+                     chunkIndex->chunks);
+    shuffleWithinChunks(order, chunkIndex->chunks);
+    
+    std::vector<glm::vec3> scratch;
+    for (PointChunk& chunk : chunkIndex->chunks) {
+        const uint32_t* indices = order.data() + chunk.first;
+        scratch.resize(chunk.count);
+        for (uint32_t i = 0; i < chunk.count; ++i) {
+            scratch[i] = points[indices[i]];
+        }
+        computePointBounds(scratch.data(), chunk.count, chunk.min, chunk.max);
+        
+        uint8_t* positionDst = dst + chunk.first * layout.positionStride;
+        if (layout.quantized) {
+            quantizePositions(scratch.data(), chunk.count, layout.scale, layout.offset,
+                              reinterpret_cast<int16_t*>(positionDst));
+        } else {
+            std::memcpy(positionDst, scratch.data(), chunk.count * sizeof(glm::vec3));
+        }
         
-        // 添加颜色
-        vertices.push_back(m_pointCloudData.colors[i].r);
-        vertices.push_back(m_pointCloudData.colors[i].g);
-        vertices.push_back(m_pointCloudData.colors[i].b);
+        if (layout.hasColors) {
+            // 如果颜色不足，缺少颜色的点使用默认颜色（白色）
+            for (uint32_t i = 0; i < chunk.count; ++i) {
+                scratch[i] = indices[i] < colors.size() ? colors[indices[i]] : glm::vec3(1.0f);
+            }
+            packColorsRGBA8(scratch.data(), chunk.count,
+                            reinterpret_cast<uint32_t*>(dst + layout.positionBytes) + chunk.first);
+        }
+        writeAttributes(pointCloud, layout, dst, indices, chunk.first, chunk.count);
     }
     
-    // 更新点数
-    m_pointCount = m_pointCloudData.points.size();
+    // 局部修改按原始下标给出，记录每个点在缓冲区中的位置
+    chunkIndex->packedIndex.resize(layout.count);
+    for (size_t i = 0; i < layout.count; ++i) {
+        chunkIndex->packedIndex[order[i]] = static_cast<uint32_t>(i);
+    }
+}
+
+int PointCloudVisual::VertexLayout::findAttribute(const char* name) const {
+    for (size_t i = 0; i < attributes.size(); ++i) {
+        if (attributes[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void PointCloudVisual::prepareAttributes(const PointCloudData& pointCloud, VertexLayout& layout) {
+    for (AttributeBlock& block : layout.attributes) {
+        const PointAttribute& attribute = *pointCloud.findAttribute(block.name);
+        const size_t count = std::min(attribute.size(), layout.count);
+        
+        double min = 0.0;
+        double max = 0.0;
+        visitAttributeData(attribute, [&](const auto* values) {
+            if (count > 0) {
+                const auto range = std::minmax_element(values, values + count);
+                min = static_cast<double>(*range.first);
+                max = static_cast<double>(*range.second);
+            }
+        });
+        block.min = static_cast<float>(min);
+        block.max = static_cast<float>(max);
+        
+        // 能用uint16表示的整数（如线束编号和标签）按原值上传，其他属性按取值范围量化
+        if (isIntegerAttributeType(attribute.getType()) && min >= 0.0 && max <= SCALAR_QUANTIZED_MAX) {
+            block.scale = 1.0f;
+            block.bias = 0.0f;
+        } else {
+            block.scale = static_cast<float>((max - min) / SCALAR_QUANTIZED_MAX);
+            block.bias = static_cast<float>(min);
+        }
+    }
+}
+
+void PointCloudVisual::writeAttributes(const PointCloudData& pointCloud, const VertexLayout& layout, uint8_t* dst,
+                                       const uint32_t* indices, size_t first, size_t count) {
+    for (const AttributeBlock& block : layout.attributes) {
+        const PointAttribute& attribute = *pointCloud.findAttribute(block.name);
+        const size_t valueCount = attribute.size();
+        const double bias = block.bias;
+        const double invScale = block.scale > 0.0f ? 1.0 / block.scale : 0.0;
+        uint16_t* out = reinterpret_cast<uint16_t*>(dst + block.offset) + first;
+        
+        // 属性数量不足时，缺少的点写入0（解码为最小值）
+        visitAttributeData(attribute, [&](const auto* values) {
+            for (size_t i = 0; i < count; ++i) {
+                const size_t index = indices ? indices[i] : first + i;
+                const double value = index < valueCount ? (static_cast<double>(values[index]) - bias) * invScale : 0.0;
+                out[i] = static_cast<uint16_t>(std::clamp(value + 0.5, 0.0, static_cast<double>(SCALAR_QUANTIZED_MAX)));
+            }
+        });
+    }
+}
+
+void PointCloudVisual::bindLayout(GLuint vao, GLuint buffer, size_t base, const VertexLayout& layout,
+                                  const VaoBinding& binding) {
+    const size_t step = binding.step;
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
     
-    // 绑定VAO和VBO
-    glBindVertexArray(m_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    // 顶点位置：量化的位置按整数值读入，由着色器用position_scale和position_offset还原
+    const GLsizei positionStride = static_cast<GLsizei>(layout.positionStride * step);
+    if (layout.quantized) {
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_FALSE, positionStride, (void*)base);
+    } else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, positionStride, (void*)base);
+    }
+    glEnableVertexAttribArray(0);
     
-    // 更新VBO数据
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    // 顶点颜色：归一化的RGBA8
+    if (layout.hasColors) {
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, static_cast<GLsizei>(sizeof(uint32_t) * step),
+                              (void*)(base + layout.positionBytes));
+        glEnableVertexAttribArray(1);
+    } else {
+        glDisableVertexAttribArray(1);
+    }
+    
+    // 标量属性：以整数值读入，由着色器用scalar_scale和scalar_bias还原
+    if (binding.channel >= 0 && binding.channel < static_cast<int>(layout.attributes.size())) {
+        glVertexAttribPointer(2, 1, GL_UNSIGNED_SHORT, GL_FALSE, static_cast<GLsizei>(sizeof(uint16_t) * step),
+                              (void*)(base + layout.attributes[binding.channel].offset));
+        glEnableVertexAttribArray(2);
+    } else {
+        glDisableVertexAttribArray(2);
+    }
+    
+    // 过滤用的标量属性
+    if (binding.filterChannel >= 0 && binding.filterChannel < static_cast<int>(layout.attributes.size())) {
+        glVertexAttribPointer(3, 1, GL_UNSIGNED_SHORT, GL_FALSE, static_cast<GLsizei>(sizeof(uint16_t) * step),
+                              (void*)(base + layout.attributes[binding.filterChannel].offset));
+        glEnableVertexAttribArray(3);
+    } else {
+        glDisableVertexAttribArray(3);
+    }
     
     // 解绑
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
+void PointCloudVisual::updateBinding(GLuint vao, GLuint buffer, size_t base, const VertexLayout& layout,
+                                     VaoBinding& binding, const VaoBinding& target) {
+    if (!(binding == target)) {
+        bindLayout(vao, buffer, base, layout, target);
+        binding = target;
+    }
+}
+
+void PointCloudVisual::applyLayout(GLuint buffer, size_t base, const VertexLayout& layout, ChunkIndex chunkIndex) {
+    bindLayout(m_vao, buffer, base, layout, VaoBinding());
+    m_vaoBuffer = buffer;
+    m_vaoBase = base;
+    m_vaoBinding = VaoBinding();
+    ++m_revision;
+    
+    // 更新点数、解码参数和分块
+    m_pointCount = layout.count;
+    m_layout = layout;
+    m_chunkIndex = std::move(chunkIndex);
+}
+
+void PointCloudVisual::accumulateScan() {
+    VertexLayout layout = computeLayout(*m_pointCloud);
+    if (!m_streamingBuffer) {
+        m_streamingBuffer = std::make_unique<StreamingBuffer>();
+    }
+    
+    // 先写入流式缓冲区，再由GPU复制到槽位：被替换的槽位上一帧仍在绘制，CPU直接写入需要等待
+    size_t staging = 0;
+    uint8_t* mapped = static_cast<uint8_t*>(m_streamingBuffer->beginWrite(layout.totalBytes(), staging));
+    if (!mapped) {
+        std::cerr << "Error: Failed to map point cloud buffer" << std::endl;
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+    
+    writeVertices(*m_pointCloud, layout, mapped, nullptr);
+    if (!m_streamingBuffer->endWrite()) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        m_needBufferUpdate = true;
+        return;
+    }
+    
+    reserveSlots(layout.totalBytes());
+    ScanSlot& slot = m_slots[m_nextSlot];
+    const size_t base = m_nextSlot * m_slotCapacity;
+    m_nextSlot = (m_nextSlot + 1) % m_slots.size();
+    
+    // 只复制这一帧的数据，与累积的帧数无关
+    glBindBuffer(GL_COPY_READ_BUFFER, m_streamingBuffer->getBuffer());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_accumulationBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, staging, base, layout.totalBytes());
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    // 复制完成前流式缓冲区的这一段不能被覆盖
+    m_streamingBuffer->fence();
+    
+    if (slot.vao == 0) {
+        glGenVertexArrays(1, &slot.vao);
+    }
+    bindLayout(slot.vao, m_accumulationBuffer, base, layout, VaoBinding());
+    slot.layout = layout;
+    slot.base = base;
+    slot.binding = VaoBinding();
+    ++m_revision;
+    slot.model = m_model_matrix;
+    slot.time = currentTime();
+    
+    // 数据已在GPU上，释放对CPU端数据的引用（其他持有者不受影响）
+    if (!m_retainCpuData) {
+        m_pointCloud.reset();
+    }
+}
+
+void PointCloudVisual::reserveSlots(size_t bytes) {
+    if (m_accumulationBuffer != 0 && bytes <= m_slotCapacity) {
+        return;
+    }
+    
+    // 留出余量，避免点数小幅波动时反复扩容
+    const size_t capacity = (bytes + bytes / 2 + 255) / 256 * 256;
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, m_slots.size() * capacity, nullptr, GL_DYNAMIC_DRAW);
+    
+    // 把已有的扫描复制到新缓冲区的对应槽位
+    if (m_accumulationBuffer != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, m_accumulationBuffer);
+        for (size_t i = 0; i < m_slots.size(); ++i) {
+            ScanSlot& slot = m_slots[i];
+            if (slot.layout.count == 0) continue;
+            
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, i * m_slotCapacity, i * capacity,
+                                slot.layout.totalBytes());
+            bindLayout(slot.vao, buffer, i * capacity, slot.layout, slot.binding);
+            slot.base = i * capacity;
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glDeleteBuffers(1, &m_accumulationBuffer);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    
+    m_accumulationBuffer = buffer;
+    m_slotCapacity = capacity;
+}
+
+void PointCloudVisual::releaseAccumulation() {
+    for (ScanSlot& slot : m_slots) {
+        if (slot.vao != 0) {
+            glDeleteVertexArrays(1, &slot.vao);
+        }
+        slot = ScanSlot();
+    }
+    
+    if (m_accumulationBuffer != 0) {
+        glDeleteBuffers(1, &m_accumulationBuffer);
+        m_accumulationBuffer = 0;
+    }
+    m_slotCapacity = 0;
+    m_nextSlot = 0;
+}
+
+double PointCloudVisual::currentTime() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_timeOrigin).count();
+}
+
+void PointCloudVisual::submitAsyncUpload() {
+    auto upload = std::make_shared<AsyncUpload>();
+    upload->pointCloud = m_pointCloud;
+    upload->layout = computeLayout(*m_pointCloud);
+    upload->chunked = m_frustumCulling;
+    upload->worker = m_uploadWorker;
+    
+    // 上传线程持有自己的引用，不需要保留时立即释放
+    if (!m_retainCpuData) {
+        m_pointCloud.reset();
+    }
+    
+    // 在上传线程中创建新的缓冲区，打包并上传；渲染线程在此期间继续绘制旧的缓冲区
+    upload->ticket = m_uploadWorker->submit([upload]() {
+        glGenBuffers(1, &upload->buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, upload->buffer);
+        glBufferData(GL_ARRAY_BUFFER, upload->layout.totalBytes(), nullptr, GL_STATIC_DRAW);
+        
+        uint8_t* mapped = static_cast<uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, upload->layout.totalBytes(),
+                                                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        if (mapped) {
+            writeVertices(*upload->pointCloud, upload->layout, mapped, upload->chunked ? &upload->chunkIndex : nullptr);
+            upload->succeeded = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        
+        // 成功后不再需要CPU端数据；失败时保留以便重试
+        if (upload->succeeded) {
+            upload->pointCloud.reset();
+        }
+    });
+    m_pendingUpload = upload;
+}
+
+void PointCloudVisual::finishAsyncUpload() {
+    std::shared_ptr<AsyncUpload> upload = std::move(m_pendingUpload);
+    
+    if (!upload->succeeded) {
+        // 上传失败：删除新缓冲区，没有更新的点云时用原来的数据重试
+        glDeleteBuffers(1, &upload->buffer);
+        if (!m_pointCloud && !m_needBufferUpdate) {
+            m_pointCloud = upload->pointCloud;
+            m_needBufferUpdate = true;
+        }
+        return;
+    }
+    
+    // 栅栏已触发，新缓冲区的数据已就绪；旧缓冲区由驱动在之前的绘制完成后回收
+    glDeleteBuffers(1, &m_vbo);
+    m_vbo = upload->buffer;
+    m_streamingBuffer.reset();
+    applyLayout(m_vbo, 0, upload->layout, std::move(upload->chunkIndex));
+}
+
 void PointCloudVisual::cleanupGLResources() {
+    // 放弃正在进行的后台上传，由提交该任务的上传线程在上传完成后删除其缓冲区（之后可能已更换或清除上传线程）；
+    // 先取出上传线程的引用，避免清理任务持有最后一个引用而在上传线程自身中析构
+    if (m_pendingUpload) {
+        std::shared_ptr<AsyncUpload> upload = std::move(m_pendingUpload);
+        std::shared_ptr<UploadWorker> worker = std::move(upload->worker);
+        worker->discard(upload->ticket, [upload]() {
+            glDeleteBuffers(1, &upload->buffer);
+        });
+    }
+    
+    // 删除累积模式的槽位和缓冲区
+    releaseAccumulation();
+    
+    // 删除流式缓冲区
+    m_streamingBuffer.reset();
+    
     // 删除VBO和VAO
     if (m_vbo != 0) {
         glDeleteBuffers(1, &m_vbo);
@@ -0,0 +1,186 @@
+#include "visualization/PointPacking.h"
+#include "core/CpuFeatures.h"
+#include <cmath>
+#include <limits>
+
+// 包围盒只用SSE，属于x86_64的基线指令集；量化和颜色打包需要SSSE3，按函数启用并在运行时检查CPU
+#if defined(MVIZ_X86)
+#include <tmmintrin.h>
+#endif
+
+namespace mviz {
+
+namespace {
+
+// 截断到[lo, hi]，NaN映射为lo（与SIMD路径的行为一致）
+inline float clampValue(float value, float lo, float hi) {
+    return value >= lo ? (value <= hi ? value : hi) : lo;
+}
+
+#if defined(MVIZ_X86)
+// quantizePositions的SSSE3版本，每次处理4个点，返回已处理的点数
+MVIZ_TARGET_SSSE3 size_t quantizePositionsSSSE3(const glm::vec3* points, size_t count, const glm::vec3& offset,
+                                                 const glm::vec3& inverse, int16_t* out) {
+    size_t i = 0;
+    
+    // 与computePointBounds相同的分量排列，偏移和缩放也按xyzx、yzxy、zxyz排列
+    const float* data = &points[0].x;
+    const __m128 offset0 = _mm_setr_ps(offset.x, offset.y, offset.z, offset.x);
+    const __m128 offset1 = _mm_setr_ps(offset.y, offset.z, offset.x, offset.y);
+    const __m128 offset2 = _mm_setr_ps(offset.z, offset.x, offset.y, offset.z);
+    const __m128 inverse0 = _mm_setr_ps(inverse.x, inverse.y, inverse.z, inverse.x);
+    const __m128 inverse1 = _mm_setr_ps(inverse.y, inverse.z, inverse.x, inverse.y);
+    const __m128 inverse2 = _mm_setr_ps(inverse.z, inverse.x, inverse.y, inverse.z);
+    
+    // 把连续的xyz int16插入填充位：每个点占8字节，第4个分量为0
+    const __m128i spread = _mm_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i q0 = _mm_cvtps_epi32(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(data + 3 * i), offset0), inverse0));
+        const __m128i q1 = _mm_cvtps_epi32(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(data + 3 * i + 4), offset1), inverse1));
+        const __m128i q2 = _mm_cvtps_epi32(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(data + 3 * i + 8), offset2), inverse2));
+        
+        // 饱和转换为int16：a = x0 y0 z0 x1 y1 z1 x2 y2，b = z2 x3 y3 z3（重复一次）
+        const __m128i a = _mm_packs_epi32(q0, q1);
+        const __m128i b = _mm_packs_epi32(q2, q2);
+        
+        // 第3、4个点从a的后4个字节和b拼接：x2 y2 z2 x3 y3 z3 ...
+        const __m128i c = _mm_alignr_epi8(b, a, 12);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i), _mm_shuffle_epi8(a, spread));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i + 8), _mm_shuffle_epi8(c, spread));
+    }
+    return i;
+}
+
+// packColorsRGBA8的SSSE3版本，每次处理4个颜色，返回已处理的数量
+MVIZ_TARGET_SSSE3 size_t packColorsRGBA8SSSE3(const glm::vec3* colors, size_t count, uint32_t* out) {
+    size_t i = 0;
+    
+    const float* data = &colors[0].r;
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 full = _mm_set1_ps(255.0f);
+    
+    // 连续的rgb字节之间插入alpha位置，再统一填入255
+    const __m128i spread = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    for (; i + 4 <= count; i += 4) {
+        // max在前：NaN被映射为0
+        const __m128i c0 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(data + 3 * i), full), zero), full));
+        const __m128i c1 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(data + 3 * i + 4), full), zero), full));
+        const __m128i c2 = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(data + 3 * i + 8), full), zero), full));
+        
+        // 前12个字节依次为4个点的rgb
+        const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(c0, c1), _mm_packs_epi32(c2, c2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_or_si128(_mm_shuffle_epi8(bytes, spread), alpha));
+    }
+    return i;
+}
+#endif
+
+} // namespace
+
+void computePointBounds(const glm::vec3* points, size_t count, glm::vec3& min, glm::vec3& max) {
+    if (count == 0) {
+        return;
+    }
+    
+    // 从空包围盒开始，NaN坐标（驱动常用来标记无效点）不参与比较：
+    // 标量路径中与NaN的比较为false，_mm_min_ps/_mm_max_ps在任一操作数为NaN时返回第二个操作数（累积值）
+    glm::vec3 lower(std::numeric_limits<float>::infinity());
+    glm::vec3 upper(-std::numeric_limits<float>::infinity());
+    size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+    // 每次读取4个点的12个浮点数，三个寄存器中的分量排列分别为xyzx、yzxy、zxyz
+    const float* data = &points[0].x;
+    __m128 min0 = _mm_set1_ps(lower.x), min1 = min0, min2 = min0;
+    __m128 max0 = _mm_set1_ps(upper.x), max1 = max0, max2 = max0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 v0 = _mm_loadu_ps(data + 3 * i);
+        const __m128 v1 = _mm_loadu_ps(data + 3 * i + 4);
+        const __m128 v2 = _mm_loadu_ps(data + 3 * i + 8);
+        min0 = _mm_min_ps(v0, min0);
+        min1 = _mm_min_ps(v1, min1);
+        min2 = _mm_min_ps(v2, min2);
+        max0 = _mm_max_ps(v0, max0);
+        max1 = _mm_max_ps(v1, max1);
+        max2 = _mm_max_ps(v2, max2);
+    }
+    
+    // 合并各通道中同一分量的结果
+    alignas(16) float lo[12], hi[12];
+    _mm_store_ps(lo, min0);
+    _mm_store_ps(lo + 4, min1);
+    _mm_store_ps(lo + 8, min2);
+    _mm_store_ps(hi, max0);
+    _mm_store_ps(hi + 4, max1);
+    _mm_store_ps(hi + 8, max2);
+    for (int lane = 0; lane < 12; ++lane) {
+        const int axis = lane % 3;
+        lower[axis] = lo[lane] < lower[axis] ? lo[lane] : lower[axis];
+        upper[axis] = hi[lane] > upper[axis] ? hi[lane] : upper[axis];
+    }
+#endif
+
+    for (; i < count; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            lower[axis] = points[i][axis] < lower[axis] ? points[i][axis] : lower[axis];
+            upper[axis] = points[i][axis] > upper[axis] ? points[i][axis] : upper[axis];
+        }
+    }
+    
+    // 某个分量上没有有效值时保持原来的包围盒
+    if (lower.x <= upper.x && lower.y <= upper.y && lower.z <= upper.z) {
+        min = lower;
+        max = upper;
+    }
+}
+
+void computeQuantization(const glm::vec3& min, const glm::vec3& max, glm::vec3& scale, glm::vec3& offset) {
+    offset = (min + max) * 0.5f;
+    for (int axis = 0; axis < 3; ++axis) {
+        // 包围盒在该方向上没有厚度时，任意缩放都能精确表示
+        float halfExtent = (max[axis] - min[axis]) * 0.5f;
+        scale[axis] = halfExtent > 0.0f ? halfExtent / QUANTIZED_MAX : 1.0f;
+    }
+}
+
+void quantizePositions(const glm::vec3* points, size_t count, const glm::vec3& scale, const glm::vec3& offset,
+                       int16_t* out) {
+    const glm::vec3 inverse = glm::vec3(1.0f) / scale;
+    size_t i = 0;
+
+#if defined(MVIZ_X86)
+    if (cpuSupportsSSSE3()) {
+        i = quantizePositionsSSSE3(points, count, offset, inverse, out);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            float value = std::nearbyint((points[i][axis] - offset[axis]) * inverse[axis]);
+            out[4 * i + axis] = static_cast<int16_t>(clampValue(value, -32768.0f, 32767.0f));
+        }
+        out[4 * i + 3] = 0;
+    }
+}
+
+void packColorsRGBA8(const glm::vec3* colors, size_t count, uint32_t* out) {
+    size_t i = 0;
+
+#if defined(MVIZ_X86)
+    if (cpuSupportsSSSE3()) {
+        i = packColorsRGBA8SSSE3(colors, count, out);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        uint32_t r = static_cast<uint32_t>(std::nearbyint(clampValue(colors[i].r * 255.0f, 0.0f, 255.0f)));
+        uint32_t g = static_cast<uint32_t>(std::nearbyint(clampValue(colors[i].g * 255.0f, 0.0f, 255.0f)));
+        uint32_t b = static_cast<uint32_t>(std::nearbyint(clampValue(colors[i].b * 255.0f, 0.0f, 255.0f)));
+        
+        // 按小端字节序排列为r、g、b、a
+        out[i] = r | (g << 8) | (b << 16) | 0xFF000000u;
+    }
+}
+
+} // namespace mviz 
\ No newline at end of file
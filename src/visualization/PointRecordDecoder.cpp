@@ -0,0 +1,326 @@
+#include "visualization/PointRecordDecoder.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace mviz {
+
+namespace {
+
+// 特化布局中不存在的字段
+constexpr size_t NO_FIELD = static_cast<size_t>(-1);
+
+// 没有颜色字段时输出的颜色（白色）
+constexpr uint32_t DEFAULT_COLOR = 0xFFFFFFFFu;
+
+// 字段类型的字节数
+size_t pointFieldSize(PointFieldType type) {
+    switch (type) {
+        case PointFieldType::INT8:
+        case PointFieldType::UINT8:
+            return 1;
+        case PointFieldType::INT16:
+        case PointFieldType::UINT16:
+            return 2;
+        case PointFieldType::INT32:
+        case PointFieldType::UINT32:
+        case PointFieldType::FLOAT32:
+            return 4;
+        case PointFieldType::FLOAT64:
+            return 8;
+    }
+    return 0;
+}
+
+// 从未对齐的地址读取
+template <typename T>
+inline T load(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// 按字段类型读取一个值
+double readValue(const uint8_t* data, PointFieldType type) {
+    switch (type) {
+        case PointFieldType::INT8:
+            return load<int8_t>(data);
+        case PointFieldType::UINT8:
+            return load<uint8_t>(data);
+        case PointFieldType::INT16:
+            return load<int16_t>(data);
+        case PointFieldType::UINT16:
+            return load<uint16_t>(data);
+        case PointFieldType::INT32:
+            return load<int32_t>(data);
+        case PointFieldType::UINT32:
+            return load<uint32_t>(data);
+        case PointFieldType::FLOAT32:
+            return load<float>(data);
+        case PointFieldType::FLOAT64:
+            return load<double>(data);
+    }
+    return 0.0;
+}
+
+// 打包颜色（PointCloud2/PCL的rgb字段，数值为0x00RRGGBB）转换为RGBA8，a固定为255
+inline uint32_t packedToRGBA8(uint32_t packed) {
+    return ((packed >> 16) & 0xFFu) | (packed & 0xFF00u) | ((packed & 0xFFu) << 16) | 0xFF000000u;
+}
+
+// 用一个点扩大包围盒，NaN分量不参与比较
+inline void expandBounds(const float* xyz, glm::vec3& min, glm::vec3& max) {
+    for (int axis = 0; axis < 3; ++axis) {
+        min[axis] = xyz[axis] < min[axis] ? xyz[axis] : min[axis];
+        max[axis] = xyz[axis] > max[axis] ? xyz[axis] : max[axis];
+    }
+}
+
+// 有有效点时写回包围盒
+inline void storeBounds(const glm::vec3& min, const glm::vec3& max, PointDecodeTarget& target) {
+    if (min.x <= max.x && min.y <= max.y && min.z <= max.z) {
+        target.min = min;
+        target.max = max;
+    }
+}
+
+// 特化的解码函数：x、y、z为偏移0、4、8的float，强度为float，颜色为打包的32位值；
+// 步长和偏移都是编译期常量，编译器可以展开地址计算并去掉不存在字段的分支
+template <size_t Step, size_t IntensityOffset, size_t RgbOffset>
+void decodeFixed(const uint8_t* data, size_t count, PointDecodeTarget& target) {
+    glm::vec3* positions = target.positions;
+    uint32_t* colors = target.colors;
+    float* intensity = target.intensity;
+    
+    glm::vec3 min(std::numeric_limits<float>::infinity());
+    glm::vec3 max(-std::numeric_limits<float>::infinity());
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* record = data + i * Step;
+        float xyz[3];
+        std::memcpy(xyz, record, sizeof(xyz));
+        expandBounds(xyz, min, max);
+        if (positions) {
+            std::memcpy(&positions[i], xyz, sizeof(xyz));
+        }
+        
+        if constexpr (IntensityOffset != NO_FIELD) {
+            if (intensity) {
+                std::memcpy(&intensity[i], record + IntensityOffset, sizeof(float));
+            }
+        }
+        if constexpr (RgbOffset != NO_FIELD) {
+            if (colors) {
+                colors[i] = packedToRGBA8(load<uint32_t>(record + RgbOffset));
+            }
+        }
+    }
+    
+    if constexpr (IntensityOffset == NO_FIELD) {
+        if (intensity) {
+            std::fill(intensity, intensity + count, 0.0f);
+        }
+    }
+    if constexpr (RgbOffset == NO_FIELD) {
+        if (colors) {
+            std::fill(colors, colors + count, DEFAULT_COLOR);
+        }
+    }
+    storeBounds(min, max, target);
+}
+
+// 有特化版本的布局
+struct FixedLayout {
+    const char* name;
+    size_t step;
+    size_t intensityOffset;
+    size_t rgbOffset;
+    PointRecordDecoder::DecodeFunction function;
+};
+
+const FixedLayout FIXED_LAYOUTS[] = {
+    {"xyz", 12, NO_FIELD, NO_FIELD, &decodeFixed<12, NO_FIELD, NO_FIELD>},
+    {"xyz_padded", 16, NO_FIELD, NO_FIELD, &decodeFixed<16, NO_FIELD, NO_FIELD>},            // PCL PointXYZ
+    {"xyzi", 16, 12, NO_FIELD, &decodeFixed<16, 12, NO_FIELD>},
+    {"xyzi_padded", 32, 16, NO_FIELD, &decodeFixed<32, 16, NO_FIELD>},                       // PCL PointXYZI
+    {"xyzrgb", 16, NO_FIELD, 12, &decodeFixed<16, NO_FIELD, 12>},
+    {"xyzrgb_padded", 32, NO_FIELD, 16, &decodeFixed<32, NO_FIELD, 16>},                     // PCL PointXYZRGB
+    {"xyzirgb", 20, 12, 16, &decodeFixed<20, 12, 16>},
+    {"xyzirgb_padded", 32, 16, 20, &decodeFixed<32, 16, 20>},
+};
+
+// 其他字段在属性通道中的类型，没有对应类型的有符号整数存为INT32
+AttributeType attributeTypeFor(PointFieldType type) {
+    switch (type) {
+        case PointFieldType::UINT8:
+            return AttributeType::UINT8;
+        case PointFieldType::UINT16:
+            return AttributeType::UINT16;
+        case PointFieldType::UINT32:
+            return AttributeType::UINT32;
+        case PointFieldType::FLOAT32:
+            return AttributeType::FLOAT32;
+        case PointFieldType::FLOAT64:
+            return AttributeType::FLOAT64;
+        default:
+            return AttributeType::INT32;
+    }
+}
+
+// 把一个字段逐点复制到属性通道
+template <typename T>
+void copyField(const uint8_t* data, size_t count, size_t step, const PointField& field, T* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<T>(readValue(data + i * step + field.offset, field.type));
+    }
+}
+
+} // namespace
+
+PointRecordDecoder::PointRecordDecoder(const std::vector<PointField>& fields, size_t pointStep, bool specialize)
+    : m_pointStep(pointStep)
+    , m_valid(false)
+    , m_layoutName("generic")
+    , m_function(nullptr)
+{
+    for (const PointField& field : fields) {
+        // 数组字段和超出记录范围的字段不解码
+        const size_t size = pointFieldSize(field.type);
+        if (field.count != 1 || size == 0 || field.offset + size > pointStep) {
+            continue;
+        }
+        
+        FieldAccess access;
+        access.offset = static_cast<long>(field.offset);
+        access.type = field.type;
+        if (field.name == "x") {
+            m_x = access;
+        } else if (field.name == "y") {
+            m_y = access;
+        } else if (field.name == "z") {
+            m_z = access;
+        } else if (field.name == "intensity") {
+            m_intensity = access;
+        } else if ((field.name == "rgb" || field.name == "rgba") && size == 4) {
+            m_rgb = access;
+        } else {
+            m_extraFields.push_back(field);
+        }
+    }
+    
+    m_valid = m_x.present() && m_y.present() && m_z.present();
+    if (!m_valid || !specialize) {
+        return;
+    }
+    
+    // 只有位置为偏移0、4、8的float、强度为float时才可能匹配特化布局
+    if (m_x.offset != 0 || m_y.offset != 4 || m_z.offset != 8 || m_x.type != PointFieldType::FLOAT32 ||
+        m_y.type != PointFieldType::FLOAT32 || m_z.type != PointFieldType::FLOAT32) {
+        return;
+    }
+    if (m_intensity.present() && m_intensity.type != PointFieldType::FLOAT32) {
+        return;
+    }
+    
+    const size_t intensityOffset = m_intensity.present() ? static_cast<size_t>(m_intensity.offset) : NO_FIELD;
+    const size_t rgbOffset = m_rgb.present() ? static_cast<size_t>(m_rgb.offset) : NO_FIELD;
+    for (const FixedLayout& layout : FIXED_LAYOUTS) {
+        if (layout.step == pointStep && layout.intensityOffset == intensityOffset && layout.rgbOffset == rgbOffset) {
+            m_layoutName = layout.name;
+            m_function = layout.function;
+            break;
+        }
+    }
+}
+
+void PointRecordDecoder::decode(const uint8_t* data, size_t count, PointDecodeTarget& target) const {
+    if (!m_valid) {
+        return;
+    }
+    
+    if (m_function) {
+        m_function(data, count, target);
+    } else {
+        decodeGeneric(data, count, target);
+    }
+}
+
+void PointRecordDecoder::decode(const uint8_t* data, size_t count, PointCloudData& pointCloud) const {
+    pointCloud.points.resize(count);
+    pointCloud.colors.clear();
+    pointCloud.attributes.clear();
+    if (!m_valid) {
+        pointCloud.points.clear();
+        return;
+    }
+    
+    // 位置和强度直接解码到点云中；点云的颜色为浮点RGB，从打包的颜色字段直接转换，不经过RGBA8
+    PointDecodeTarget target;
+    target.positions = pointCloud.points.data();
+    if (hasIntensity()) {
+        PointAttribute& intensity = pointCloud.addAttribute(ATTRIBUTE_INTENSITY, AttributeType::FLOAT32);
+        intensity.resize(count);
+        target.intensity = intensity.data<float>();
+    }
+    decode(data, count, target);
+    
+    if (hasColors()) {
+        pointCloud.colors.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t packed = load<uint32_t>(data + i * m_pointStep + m_rgb.offset);
+            pointCloud.colors[i] = glm::vec3((packed >> 16) & 0xFFu, (packed >> 8) & 0xFFu, packed & 0xFFu) / 255.0f;
+        }
+    }
+    
+    for (const PointField& field : m_extraFields) {
+        PointAttribute& attribute = pointCloud.addAttribute(field.name, attributeTypeFor(field.type));
+        attribute.resize(count);
+        switch (attribute.getType()) {
+            case AttributeType::UINT8:
+                copyField(data, count, m_pointStep, field, attribute.data<uint8_t>());
+                break;
+            case AttributeType::UINT16:
+                copyField(data, count, m_pointStep, field, attribute.data<uint16_t>());
+                break;
+            case AttributeType::UINT32:
+                copyField(data, count, m_pointStep, field, attribute.data<uint32_t>());
+                break;
+            case AttributeType::INT32:
+                copyField(data, count, m_pointStep, field, attribute.data<int32_t>());
+                break;
+            case AttributeType::FLOAT32:
+                copyField(data, count, m_pointStep, field, attribute.data<float>());
+                break;
+            case AttributeType::FLOAT64:
+                copyField(data, count, m_pointStep, field, attribute.data<double>());
+                break;
+        }
+    }
+}
+
+void PointRecordDecoder::decodeGeneric(const uint8_t* data, size_t count, PointDecodeTarget& target) const {
+    glm::vec3 min(std::numeric_limits<float>::infinity());
+    glm::vec3 max(-std::numeric_limits<float>::infinity());
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* record = data + i * m_pointStep;
+        const float xyz[3] = {
+            static_cast<float>(readValue(record + m_x.offset, m_x.type)),
+            static_cast<float>(readValue(record + m_y.offset, m_y.type)),
+            static_cast<float>(readValue(record + m_z.offset, m_z.type))
+        };
+        expandBounds(xyz, min, max);
+        if (target.positions) {
+            target.positions[i] = glm::vec3(xyz[0], xyz[1], xyz[2]);
+        }
+        
+        if (target.intensity) {
+            target.intensity[i] =
+                m_intensity.present() ? static_cast<float>(readValue(record + m_intensity.offset, m_intensity.type)) : 0.0f;
+        }
+        if (target.colors) {
+            target.colors[i] = m_rgb.present() ? packedToRGBA8(load<uint32_t>(record + m_rgb.offset)) : DEFAULT_COLOR;
+        }
+    }
+    storeBounds(min, max, target);
+}
+
+} // namespace mviz 
\ No newline at end of file
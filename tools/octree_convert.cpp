@@ -0,0 +1,368 @@
+// 八叉树点云转换工具：把大规模点云转换为OctreePointCloudVisual使用的八叉树文件
+//
+// 用法：mviz_octree_convert 输入文件 输出文件 [--grid 分辨率] [--max-leaf 点数] [--bucket-points 点数] [--temp 目录]
+// 支持的输入格式：
+//   .xyz/.txt  每行 x y z [r g b]，颜色为0-255的整数或[0, 1]的小数
+//   .ply       ascii或binary_little_endian，vertex元素的float/double类型x、y、z属性和可选的uchar类型red、green、blue属性
+
+#include "data/OctreeBuilder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace mviz {
+namespace {
+
+// 文件扩展名（小写）
+std::string extensionOf(const std::string& path) {
+    const size_t dot = path.find_last_of('.');
+    std::string extension = dot == std::string::npos ? std::string() : path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension;
+}
+
+// ASCII点云：每行 x y z [r g b]
+class XyzPointSource : public OctreePointSource {
+public:
+    explicit XyzPointSource(const std::string& path)
+        : m_path(path)
+        , m_hasColors(false)
+    {
+        // 根据第一行的列数判断是否有颜色
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream stream(line);
+            std::vector<double> values;
+            double value;
+            while (stream >> value) {
+                values.push_back(value);
+            }
+            if (values.size() >= 3) {
+                m_hasColors = values.size() >= 6;
+                break;
+            }
+        }
+    }
+    
+    bool hasColors() const override { return m_hasColors; }
+    
+    bool rewind() override {
+        m_file.close();
+        m_file.clear();
+        m_file.open(m_path);
+        return static_cast<bool>(m_file);
+    }
+    
+    size_t read(std::vector<glm::vec3>& points, std::vector<glm::vec3>& colors, size_t maxCount) override {
+        size_t count = 0;
+        std::string line;
+        while (count < maxCount && std::getline(m_file, line)) {
+            double values[6];
+            const char* cursor = line.c_str();
+            int parsed = 0;
+            for (; parsed < 6; ++parsed) {
+                char* end = nullptr;
+                values[parsed] = std::strtod(cursor, &end);
+                if (end == cursor) break;
+                cursor = end;
+            }
+            
+            // 跳过空行和注释等无法解析的行
+            if (parsed < 3) continue;
+            
+            points.emplace_back(values[0], values[1], values[2]);
+            if (m_hasColors) {
+                glm::vec3 color(1.0f);
+                if (parsed >= 6) {
+                    const bool normalized = values[3] <= 1.0 && values[4] <= 1.0 && values[5] <= 1.0;
+                    const float scale = normalized ? 1.0f : 1.0f / 255.0f;
+                    color = glm::vec3(values[3] * scale, values[4] * scale, values[5] * scale);
+                }
+                colors.push_back(color);
+            }
+            ++count;
+        }
+        return count;
+    }
+    
+private:
+    std::string m_path;
+    std::ifstream m_file;
+    bool m_hasColors;
+};
+
+// PLY点云：只读取vertex元素中的坐标和颜色
+class PlyPointSource : public OctreePointSource {
+public:
+    explicit PlyPointSource(const std::string& path)
+        : m_path(path)
+        , m_binary(false)
+        , m_vertexCount(0)
+        , m_vertexStride(0)
+        , m_dataOffset(0)
+        , m_remaining(0)
+        , m_valid(false)
+    {
+        m_valid = parseHeader();
+    }
+    
+    bool isValid() const { return m_valid; }
+    
+    bool hasColors() const override { return m_properties[3].offset >= 0; }
+    
+    bool rewind() override {
+        m_file.close();
+        m_file.clear();
+        m_file.open(m_path, std::ios::binary);
+        m_file.seekg(m_dataOffset);
+        m_remaining = m_vertexCount;
+        return m_valid && static_cast<bool>(m_file);
+    }
+    
+    size_t read(std::vector<glm::vec3>& points, std::vector<glm::vec3>& colors, size_t maxCount) override {
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(maxCount, m_remaining));
+        if (count == 0) {
+            return 0;
+        }
+        
+        if (m_binary) {
+            m_buffer.resize(count * m_vertexStride);
+            m_file.read(reinterpret_cast<char*>(m_buffer.data()), m_buffer.size());
+            const size_t readCount = static_cast<size_t>(m_file.gcount()) / m_vertexStride;
+            for (size_t i = 0; i < readCount; ++i) {
+                const uint8_t* vertex = m_buffer.data() + i * m_vertexStride;
+                points.emplace_back(binaryValue(vertex, 0), binaryValue(vertex, 1), binaryValue(vertex, 2));
+                if (hasColors()) {
+                    colors.emplace_back(binaryValue(vertex, 3) / 255.0, binaryValue(vertex, 4) / 255.0,
+                                        binaryValue(vertex, 5) / 255.0);
+                }
+            }
+            m_remaining = readCount == count ? m_remaining - count : 0;
+            return readCount;
+        }
+        
+        std::string line;
+        std::vector<double> values(m_asciiColumns);
+        size_t readCount = 0;
+        while (readCount < count && std::getline(m_file, line)) {
+            std::istringstream stream(line);
+            for (double& value : values) {
+                stream >> value;
+            }
+            if (!stream) continue;
+            
+            points.emplace_back(values[m_properties[0].offset], values[m_properties[1].offset], values[m_properties[2].offset]);
+            if (hasColors()) {
+                colors.emplace_back(values[m_properties[3].offset] / 255.0, values[m_properties[4].offset] / 255.0,
+                                    values[m_properties[5].offset] / 255.0);
+            }
+            ++readCount;
+        }
+        m_remaining = readCount == count ? m_remaining - count : 0;
+        return readCount;
+    }
+    
+private:
+    // 需要读取的属性：x、y、z、red、green、blue；offset为二进制中的字节偏移或ASCII中的列号，-1表示不存在
+    struct Property {
+        long offset = -1;
+        std::string type;
+    };
+    
+    bool parseHeader() {
+        std::ifstream file(m_path, std::ios::binary);
+        std::string line;
+        if (!std::getline(file, line) || line.compare(0, 3, "ply") != 0) {
+            std::cerr << "Not a PLY file: " << m_path << std::endl;
+            return false;
+        }
+        
+        static const char* names[6] = {"x", "y", "z", "red", "green", "blue"};
+        bool inVertex = false;
+        bool vertexSeen = false;
+        bool otherElementFirst = false;
+        long column = 0;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            std::istringstream stream(line);
+            std::string keyword;
+            stream >> keyword;
+            
+            if (keyword == "format") {
+                std::string format;
+                stream >> format;
+                if (format != "ascii" && format != "binary_little_endian") {
+                    std::cerr << "Unsupported PLY format: " << format << std::endl;
+                    return false;
+                }
+                m_binary = format != "ascii";
+            } else if (keyword == "element") {
+                std::string name;
+                uint64_t count = 0;
+                stream >> name >> count;
+                inVertex = name == "vertex";
+                if (!inVertex) {
+                    otherElementFirst = otherElementFirst || !vertexSeen;
+                } else {
+                    // vertex元素之前的元素会改变数据起始位置，不支持
+                    if (otherElementFirst) {
+                        std::cerr << "PLY vertex element must come first" << std::endl;
+                        return false;
+                    }
+                    vertexSeen = true;
+                    m_vertexCount = count;
+                }
+            } else if (keyword == "property" && inVertex) {
+                std::string type, name;
+                stream >> type;
+                if (type == "list") {
+                    std::cerr << "Unsupported list property in PLY vertex element" << std::endl;
+                    return false;
+                }
+                stream >> name;
+                const size_t size = typeSize(type);
+                if (size == 0) {
+                    std::cerr << "Unsupported PLY property type: " << type << std::endl;
+                    return false;
+                }
+                for (int i = 0; i < 6; ++i) {
+                    if (name == names[i]) {
+                        m_properties[i].offset = m_binary ? static_cast<long>(m_vertexStride) : column;
+                        m_properties[i].type = type;
+                    }
+                }
+                m_vertexStride += size;
+                ++column;
+            } else if (keyword == "end_header") {
+                m_dataOffset = file.tellg();
+                break;
+            }
+        }
+        
+        m_asciiColumns = static_cast<size_t>(column);
+        for (int i = 0; i < 3; ++i) {
+            if (m_properties[i].offset < 0) {
+                std::cerr << "PLY vertex element has no " << names[i] << " property" << std::endl;
+                return false;
+            }
+        }
+        
+        // 颜色需要三个分量齐全
+        if (m_properties[3].offset < 0 || m_properties[4].offset < 0 || m_properties[5].offset < 0) {
+            m_properties[3].offset = -1;
+        }
+        return m_dataOffset > 0;
+    }
+    
+    static size_t typeSize(const std::string& type) {
+        if (type == "char" || type == "uchar" || type == "int8" || type == "uint8") return 1;
+        if (type == "short" || type == "ushort" || type == "int16" || type == "uint16") return 2;
+        if (type == "int" || type == "uint" || type == "float" || type == "int32" || type == "uint32" || type == "float32") return 4;
+        if (type == "double" || type == "float64") return 8;
+        return 0;
+    }
+    
+    // 读取二进制顶点中的一个属性，转换为double
+    double binaryValue(const uint8_t* vertex, int property) const {
+        const Property& info = m_properties[property];
+        const uint8_t* data = vertex + info.offset;
+        const std::string& type = info.type;
+        auto load = [data](auto value) {
+            std::memcpy(&value, data, sizeof(value));
+            return static_cast<double>(value);
+        };
+        if (type == "float" || type == "float32") return load(float());
+        if (type == "double" || type == "float64") return load(double());
+        if (type == "uchar" || type == "uint8") return load(uint8_t());
+        if (type == "char" || type == "int8") return load(int8_t());
+        if (type == "ushort" || type == "uint16") return load(uint16_t());
+        if (type == "short" || type == "int16") return load(int16_t());
+        if (type == "uint" || type == "uint32") return load(uint32_t());
+        return load(int32_t());
+    }
+    
+    std::string m_path;
+    std::ifstream m_file;
+    bool m_binary;
+    uint64_t m_vertexCount;
+    size_t m_vertexStride;
+    size_t m_asciiColumns = 0;
+    std::streamoff m_dataOffset;
+    uint64_t m_remaining;
+    Property m_properties[6];
+    std::vector<uint8_t> m_buffer;
+    bool m_valid;
+};
+
+std::unique_ptr<OctreePointSource> openPointSource(const std::string& path) {
+    const std::string extension = extensionOf(path);
+    if (extension == "ply") {
+        auto source = std::make_unique<PlyPointSource>(path);
+        if (!source->isValid()) {
+            return nullptr;
+        }
+        return source;
+    }
+    if (extension == "xyz" || extension == "txt") {
+        return std::make_unique<XyzPointSource>(path);
+    }
+    
+    std::cerr << "Unsupported input format: " << path << std::endl;
+    return nullptr;
+}
+
+} // namespace
+} // namespace mviz
+
+int main(int argc, char* argv[]) {
+    using namespace mviz;
+    
+    const char* usage = " input output [--grid size] [--max-leaf points] [--bucket-points points] [--temp directory]";
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << usage << std::endl;
+        return 1;
+    }
+    
+    OctreeBuildOptions options;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--grid") == 0 && i + 1 < argc) {
+            options.gridSize = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-leaf") == 0 && i + 1 < argc) {
+            options.maxLeafPoints = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--bucket-points") == 0 && i + 1 < argc) {
+            options.maxBucketPoints = static_cast<uint64_t>(std::atoll(argv[++i]));
+        } else if (std::strcmp(argv[i], "--temp") == 0 && i + 1 < argc) {
+            options.tempDirectory = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << usage << std::endl;
+            return 1;
+        }
+    }
+    
+    std::unique_ptr<OctreePointSource> source = openPointSource(argv[1]);
+    if (!source) {
+        return 1;
+    }
+    
+    const auto start = std::chrono::steady_clock::now();
+    OctreeBuildStats stats;
+    if (!buildOctree(*source, argv[2], options, &stats)) {
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    std::cout << "Converted " << stats.inputPoints << " points into " << stats.nodeCount << " nodes"
+              << " (depth " << stats.depth << ", " << (1u << (3 * stats.bucketLevel)) << " partitions) in "
+              << seconds << " s" << std::endl;
+    return 0;
+}
\ No newline at end of file